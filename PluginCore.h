@@ -0,0 +1,2435 @@
+#pragma once
+
+// Game-independent core of the plugin: everything here builds without CommonLibSSE or Windows headers, so
+// plugin.cpp and the Linux tests, benchmarks and log tools share one implementation.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ===== TIMESTAMP FORMATTING =====
+constexpr std::size_t kTimestampPrefixLength = 19;  // "YYYY-MM-DD HH:MM:SS"
+constexpr std::size_t kTimestampLength = 23;        // "YYYY-MM-DD HH:MM:SS.mmm"
+
+// Writes value as exactly width decimal digits, zero padded, and returns the end pointer.
+inline char* WriteDecimalDigits(char* out, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+// Writes "YYYY-MM-DD HH:MM:SS.mmm" to out and returns the end pointer. The
+// date/time prefix is formatted once per second per thread; every other call
+// only copies it and patches the three millisecond digits.
+inline char* FormatTimestamp(std::chrono::system_clock::time_point now, char* out) {
+    thread_local std::int64_t cachedSecond = -1;
+    thread_local char cachedPrefix[kTimestampPrefixLength];
+
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
+    auto seconds = std::chrono::floor<std::chrono::seconds>(sinceEpoch);
+    auto millis = static_cast<unsigned>((sinceEpoch - seconds).count());
+
+    if (seconds.count() != cachedSecond) {
+        std::time_t time_t = static_cast<std::time_t>(seconds.count());
+        std::tm buf{};
+#if defined(_WIN32)
+        localtime_s(&buf, &time_t);
+#else
+        localtime_r(&time_t, &buf);
+#endif
+        char* prefix = cachedPrefix;
+        prefix = WriteDecimalDigits(prefix, static_cast<unsigned>(buf.tm_year + 1900), 4);
+        *prefix++ = '-';
+        prefix = WriteDecimalDigits(prefix, static_cast<unsigned>(buf.tm_mon + 1), 2);
+        *prefix++ = '-';
+        prefix = WriteDecimalDigits(prefix, static_cast<unsigned>(buf.tm_mday), 2);
+        *prefix++ = ' ';
+        prefix = WriteDecimalDigits(prefix, static_cast<unsigned>(buf.tm_hour), 2);
+        *prefix++ = ':';
+        prefix = WriteDecimalDigits(prefix, static_cast<unsigned>(buf.tm_min), 2);
+        *prefix++ = ':';
+        WriteDecimalDigits(prefix, static_cast<unsigned>(buf.tm_sec), 2);
+        cachedSecond = seconds.count();
+    }
+
+    std::memcpy(out, cachedPrefix, kTimestampPrefixLength);
+    out[19] = '.';
+    WriteDecimalDigits(out + 20, millis, 3);
+    return out + kTimestampLength;
+}
+
+// ===== LOG RECORDS =====
+enum class LogChannel : std::uint8_t {
+    Actions = 0,
+    Quest = 1,
+    System = 2
+};
+
+enum class LogLevel : std::uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4
+};
+
+constexpr std::size_t kLogChannelCount = 3;
+constexpr std::size_t kLogRingCapacity = 1024;  // must be a power of two
+constexpr std::size_t kLogRecordTextSize = 1000;
+
+enum class LogRecordKind : std::uint8_t {
+    Text = 0,
+    Deferred = 1
+};
+
+// Bounded multi-producer / single-consumer ring of log records for one
+// channel. Producers claim a slot with one CAS, copy the payload in and publish
+// it with a release store; the writer thread is the only consumer.
+class LogRingBuffer {
+public:
+    LogRingBuffer() {
+        for (std::size_t i = 0; i < kLogRingCapacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPush(LogRecordKind kind, std::int64_t timestampMs, std::string_view text) {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        for (;;) {
+            slot = &slots_[pos & kMask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t length = (std::min)(text.size(), kLogRecordTextSize);
+        slot->kind = kind;
+        slot->timestampMs = timestampMs;
+        slot->length = static_cast<std::uint16_t>(length);
+        std::memcpy(slot->text, text.data(), length);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only. Calls fn(kind, timestampMs, payload) for every published record.
+    template <class Fn>
+    std::size_t Drain(Fn&& fn) {
+        std::size_t drained = 0;
+
+        for (;;) {
+            Slot& slot = slots_[dequeuePos_ & kMask];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+                break;
+            }
+
+            fn(slot.kind, slot.timestampMs, std::string_view(slot.text, slot.length));
+
+            slot.sequence.store(dequeuePos_ + kLogRingCapacity, std::memory_order_release);
+            ++dequeuePos_;
+            ++drained;
+        }
+
+        return drained;
+    }
+
+    std::size_t TakeDroppedCount() { return droppedRecords_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    static_assert((kLogRingCapacity & (kLogRingCapacity - 1)) == 0, "Ring capacity must be a power of two");
+    static constexpr std::size_t kMask = kLogRingCapacity - 1;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        std::int64_t timestampMs = 0;
+        LogRecordKind kind = LogRecordKind::Text;
+        std::uint16_t length = 0;
+        char text[kLogRecordTextSize];
+    };
+
+    Slot slots_[kLogRingCapacity];
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::atomic<std::size_t> droppedRecords_{0};
+    alignas(64) std::size_t dequeuePos_ = 0;
+};
+
+inline const char* GetLogFileName(LogChannel channel) {
+    switch (channel) {
+        case LogChannel::Actions:
+            return "BWY-multi-Fix-NG-Actions.log";
+        case LogChannel::Quest:
+            return "BWY-multi-Fix-NG-Quest.log";
+        default:
+            return "BWY-multi-Fix-NG-System.log";
+    }
+}
+
+inline const char* GetLogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:
+            return "trace";
+        case LogLevel::Debug:
+            return "debug";
+        case LogLevel::Warning:
+            return "warning";
+        case LogLevel::Error:
+            return "error";
+        default:
+            return "info";
+    }
+}
+
+inline const char* GetLogChannelTag(LogChannel channel) {
+    switch (channel) {
+        case LogChannel::Actions:
+            return "log";
+        case LogChannel::Quest:
+            return "quest";
+        default:
+            return "system";
+    }
+}
+
+// Copies as much of text as fits before end and returns the new end pointer.
+inline char* AppendLogText(char* out, char* end, std::string_view text) {
+    std::size_t length = (std::min)(text.size(), static_cast<std::size_t>(end - out));
+    std::memcpy(out, text.data(), length);
+    return out + length;
+}
+
+// Writes "[timestamp] [tag] [level] [plugin.cpp:N] " to out, which must hold
+// kLogRecordTextSize bytes, and returns the end pointer.
+inline char* FormatLogPrefix(char* out, std::chrono::system_clock::time_point time, LogChannel channel,
+                             LogLevel level, std::uint_least32_t lineNumber) {
+    char* const end = out + kLogRecordTextSize;
+
+    *out++ = '[';
+    out = FormatTimestamp(time, out);
+    out = AppendLogText(out, end, "] [");
+    out = AppendLogText(out, end, GetLogChannelTag(channel));
+    out = AppendLogText(out, end, "] [");
+    out = AppendLogText(out, end, GetLogLevelName(level));
+    out = AppendLogText(out, end, "] [plugin.cpp:");
+    out = std::to_chars(out, end, lineNumber).ptr;
+    return AppendLogText(out, end, "] ");
+}
+
+inline std::size_t FormatLogLine(char* out, std::chrono::system_clock::time_point time, LogChannel channel,
+                                 LogLevel level, std::uint_least32_t lineNumber, std::string_view message) {
+    char* const begin = out;
+    char* const end = out + kLogRecordTextSize;
+    out = FormatLogPrefix(out, time, channel, level, lineNumber);
+    out = AppendLogText(out, end, message);
+    return static_cast<std::size_t>(out - begin);
+}
+
+// ===== DEFERRED LOG FORMATS =====
+// Fixed messages logged from the event sinks and the monitor thread. Call sites
+// push only the format ID and raw integer arguments; the writer thread renders
+// the text, so the producing thread never formats anything.
+enum class LogFormatId : std::uint16_t {
+    Separator,
+    QuestActivated,
+    QuestStageEventReceived,
+    TriggerStageReached,
+    QuestStageChanged,
+    CurrentStage,
+    NewStage,
+    TriggerStage,
+    Stage,
+    TargetStage,
+    FinalStage,
+    ContainerItemAdded,
+    ItemDetected,
+    ItemFormID,
+    ItemCount,
+    FormID,
+    Count
+};
+
+constexpr std::array<std::string_view, static_cast<std::size_t>(LogFormatId::Count)> kLogFormats = {
+    "========================================",
+    "QUEST ACTIVATED",
+    "QUEST STAGE EVENT RECEIVED",
+    "TRIGGER STAGE REACHED",
+    "Quest stage changed: {} -> {}",
+    "Current Stage: {}",
+    "New Stage: {}",
+    "Trigger Stage: {}",
+    "Stage: {}",
+    "Target Stage: {}",
+    "Final Stage: {}",
+    "CONTAINER CHANGE EVENT - ITEM ADDED TO PLAYER",
+    "ITEM DETECTED IN PLAYER INVENTORY",
+    "Item FormID: 0x{:X}",
+    "Item Count: {}",
+    "FormID: 0x{:X}"
+};
+
+// Deferred formats that mark quest milestones get their own index entry.
+constexpr bool IsIndexedLogFormat(LogFormatId format) {
+    return format == LogFormatId::QuestActivated || format == LogFormatId::QuestStageEventReceived ||
+           format == LogFormatId::TriggerStageReached || format == LogFormatId::ContainerItemAdded ||
+           format == LogFormatId::ItemDetected;
+}
+
+constexpr std::size_t kDeferredLogMaxArgs = 4;
+
+struct DeferredLogRecord {
+    std::int64_t timestampMs = 0;
+    LogFormatId format = LogFormatId::Separator;
+    LogLevel level = LogLevel::Info;
+    std::uint32_t lineNumber = 0;
+    std::array<std::int64_t, kDeferredLogMaxArgs> args{};
+};
+
+// Expands the "{}" and "{:X}" placeholders used by kLogFormats with args in
+// order; every other character is copied as is. Returns the end pointer.
+inline char* RenderLogFormat(char* out, char* end, std::string_view format, std::span<const std::int64_t> args) {
+    std::size_t nextArg = 0;
+
+    while (!format.empty() && out < end) {
+        bool hex = format.starts_with("{:X}");
+        if ((hex || format.starts_with("{}")) && nextArg < args.size()) {
+            char digits[24];
+            char* digitsEnd = std::to_chars(digits, digits + sizeof(digits), args[nextArg++], hex ? 16 : 10).ptr;
+            if (hex) {
+                std::transform(digits, digitsEnd, digits,
+                               [](char c) { return c >= 'a' && c <= 'f' ? static_cast<char>(c - 'a' + 'A') : c; });
+            }
+            out = AppendLogText(out, end, std::string_view(digits, digitsEnd - digits));
+            format.remove_prefix(hex ? 4 : 2);
+        } else {
+            *out++ = format.front();
+            format.remove_prefix(1);
+        }
+    }
+
+    return out;
+}
+
+inline std::size_t RenderDeferredLogLine(char* out, LogChannel channel, const DeferredLogRecord& record) {
+    auto format = static_cast<std::size_t>(record.format);
+    if (format >= kLogFormats.size()) {
+        return 0;
+    }
+
+    char message[kLogRecordTextSize];
+    char* messageEnd = RenderLogFormat(message, message + sizeof(message), kLogFormats[format], record.args);
+
+    std::chrono::system_clock::time_point time{std::chrono::milliseconds(record.timestampMs)};
+    return FormatLogLine(out, time, channel, record.level, record.lineNumber,
+                         std::string_view(message, messageEnd - message));
+}
+
+// ===== BINARY DEFERRED LOG =====
+// Optional compact form of the deferred records. Instead of rendering them the
+// writer appends "<channel>.blog": a session header, then per record the
+// format and level bytes, the timestamp as a zigzag varint delta from the
+// previous record, the line number as a varint and one zigzag varint per
+// placeholder of the format. bwy_logtool decode renders the text lines later.
+constexpr std::uint32_t kBinaryLogMagic = 0x42595742;  // "BWYB"
+constexpr std::uint8_t kBinaryLogVersion = 1;
+constexpr std::uint8_t kBinaryLogSessionMarker = 0xFF;
+constexpr std::size_t kBinaryLogSessionHeaderSize = 8;
+
+static_assert(kLogFormats.size() < kBinaryLogSessionMarker, "Format IDs must not collide with the session marker");
+
+constexpr std::array<std::uint8_t, kLogFormats.size()> kLogFormatArgCounts = [] {
+    std::array<std::uint8_t, kLogFormats.size()> counts{};
+    for (std::size_t i = 0; i < kLogFormats.size(); ++i) {
+        for (char c : kLogFormats[i]) {
+            counts[i] += c == '{' ? 1 : 0;
+        }
+    }
+    return counts;
+}();
+
+inline void AppendBinaryLogVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline bool ReadBinaryLogVarint(std::string_view& in, std::uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && !in.empty(); shift += 7) {
+        auto byte = static_cast<std::uint8_t>(in.front());
+        in.remove_prefix(1);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr std::uint64_t ZigZagEncode(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr std::int64_t ZigZagDecode(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Encodes the records of one channel. The first record after construction or
+// Reset() is preceded by a session header, which restarts the timestamp deltas.
+class BinaryLogEncoder {
+public:
+    void Append(std::string& out, LogChannel channel, const DeferredLogRecord& record) {
+        auto format = static_cast<std::size_t>(record.format);
+        if (format >= kLogFormats.size()) {
+            return;
+        }
+
+        if (!started_) {
+            out.push_back(static_cast<char>(kBinaryLogSessionMarker));
+            out.append(reinterpret_cast<const char*>(&kBinaryLogMagic), sizeof(kBinaryLogMagic));
+            out.push_back(static_cast<char>(kBinaryLogVersion));
+            out.push_back(static_cast<char>(channel));
+            out.push_back(static_cast<char>(kLogFormats.size()));
+            started_ = true;
+            previousTimestampMs_ = 0;
+        }
+
+        out.push_back(static_cast<char>(format));
+        out.push_back(static_cast<char>(record.level));
+        AppendBinaryLogVarint(out, ZigZagEncode(record.timestampMs - previousTimestampMs_));
+        AppendBinaryLogVarint(out, record.lineNumber);
+        for (std::size_t i = 0; i < kLogFormatArgCounts[format] && i < kDeferredLogMaxArgs; ++i) {
+            AppendBinaryLogVarint(out, ZigZagEncode(record.args[i]));
+        }
+        previousTimestampMs_ = record.timestampMs;
+    }
+
+    void Reset() { started_ = false; }
+
+private:
+    bool started_ = false;
+    std::int64_t previousTimestampMs_ = 0;
+};
+
+// Decodes records that start part way into a file, such as one indexed batch.
+// Timestamp deltas there continue from a record outside data, so the first
+// record takes firstTimestampMs (the batch's index entry carries it) and the
+// ones after it add their deltas; a session header inside data restarts them.
+// Returns false under the same conditions as DecodeBinaryLog.
+template <class Visit>
+bool DecodeBinaryLogChunk(std::string_view data, LogChannel channel, std::int64_t firstTimestampMs,
+                          Visit&& visit) {
+    std::size_t formatCount = kLogFormats.size();
+    std::int64_t previousTimestampMs = 0;
+    bool anchored = true;
+
+    while (!data.empty()) {
+        auto format = static_cast<std::uint8_t>(data.front());
+        data.remove_prefix(1);
+
+        if (format == kBinaryLogSessionMarker) {
+            if (data.size() < kBinaryLogSessionHeaderSize - 1) {
+                return false;
+            }
+            std::uint32_t magic = 0;
+            std::memcpy(&magic, data.data(), sizeof(magic));
+            auto version = static_cast<std::uint8_t>(data[4]);
+            auto channelIndex = static_cast<std::uint8_t>(data[5]);
+            formatCount = static_cast<std::uint8_t>(data[6]);
+            if (magic != kBinaryLogMagic || version != kBinaryLogVersion || channelIndex >= kLogChannelCount ||
+                formatCount > kLogFormats.size()) {
+                return false;
+            }
+            channel = static_cast<LogChannel>(channelIndex);
+            previousTimestampMs = 0;
+            anchored = false;
+            data.remove_prefix(kBinaryLogSessionHeaderSize - 1);
+            continue;
+        }
+
+        if (format >= formatCount || data.empty() ||
+            static_cast<std::uint8_t>(data.front()) > static_cast<std::uint8_t>(LogLevel::Error)) {
+            return false;
+        }
+
+        DeferredLogRecord record;
+        record.format = static_cast<LogFormatId>(format);
+        record.level = static_cast<LogLevel>(data.front());
+        data.remove_prefix(1);
+
+        std::uint64_t value = 0;
+        if (!ReadBinaryLogVarint(data, value)) {
+            return false;
+        }
+        record.timestampMs = anchored ? firstTimestampMs : previousTimestampMs + ZigZagDecode(value);
+        previousTimestampMs = record.timestampMs;
+        anchored = false;
+
+        if (!ReadBinaryLogVarint(data, value)) {
+            return false;
+        }
+        record.lineNumber = static_cast<std::uint32_t>(value);
+
+        for (std::size_t i = 0; i < kLogFormatArgCounts[format] && i < kDeferredLogMaxArgs; ++i) {
+            if (!ReadBinaryLogVarint(data, value)) {
+                return false;
+            }
+            record.args[i] = ZigZagDecode(value);
+        }
+
+        visit(channel, record);
+    }
+
+    return true;
+}
+
+// Calls visit(channel, record) for every record in data. Format IDs are only
+// ever appended, so a session written with a shorter format table decodes as
+// is. Returns false if data does not start with a session header, a header is
+// damaged or newer than this table, a record uses an ID its session did not
+// have, or a record is cut off; records before that point are visited.
+template <class Visit>
+bool DecodeBinaryLog(std::string_view data, Visit&& visit) {
+    if (data.empty() || static_cast<std::uint8_t>(data.front()) != kBinaryLogSessionMarker) {
+        return data.empty();
+    }
+    return DecodeBinaryLogChunk(data, LogChannel::System, 0, std::forward<Visit>(visit));
+}
+
+// ===== FLIGHT RECORDER =====
+constexpr std::uint32_t kFlightRecorderMagic = 0x46595742;  // "BWYF"
+constexpr std::uint32_t kFlightRecorderVersion = 2;
+constexpr std::size_t kFlightRecorderSlotCount = 2048;
+constexpr std::size_t kFlightRecorderSlotSize = 256;
+
+struct FlightRecorderHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint32_t cleanShutdown;
+    std::uint64_t nextSequence;
+    std::uint64_t persistedSequence;  // every record up to this one reached the log files
+};
+
+struct FlightRecorderSlot {
+    std::uint64_t sequence;  // 0 while the slot is being written
+    LogRecordKind kind;
+    std::uint8_t reserved;
+    std::uint16_t length;
+    char payload[kFlightRecorderSlotSize - 12];
+};
+
+static_assert(sizeof(FlightRecorderSlot) == kFlightRecorderSlotSize, "Flight recorder slots must stay packed");
+static_assert(sizeof(DeferredLogRecord) <= sizeof(FlightRecorderSlot::payload), "Deferred records must fit a slot");
+
+constexpr std::size_t kFlightRecorderFileSize =
+    kFlightRecorderSlotSize + kFlightRecorderSlotCount * sizeof(FlightRecorderSlot);
+
+inline std::filesystem::path GetFlightRecorderPath(const std::filesystem::path& directory, LogChannel channel) {
+    std::filesystem::path fileName = GetLogFileName(channel);
+    fileName.replace_extension(".flight");
+    return directory / fileName;
+}
+
+inline std::filesystem::path GetCrashTailPath(const std::filesystem::path& directory, LogChannel channel) {
+    std::filesystem::path fileName = GetLogFileName(channel);
+    fileName.replace_extension(".crash.log");
+    return directory / fileName;
+}
+
+// Fixed-size circular log tail kept in a memory-mapped file. Producers copy
+// each record straight into the mapping, so the newest lines survive a game
+// crash even if the writer thread never got to them. The game normally exits
+// without any shutdown hook running, so a session counts as crashed only when
+// it left records the writer never flushed: a normal quit has written them
+// all, and after any other exit the tail adds nothing the logs lack.
+class FlightRecorder {
+public:
+    // Formats the kFlightRecorderFileSize bytes at memory as an empty recorder
+    // and starts recording into them. The memory (a file mapping in the
+    // plugin) must outlive the recorder.
+    void Attach(void* memory) {
+        std::memset(memory, 0, kFlightRecorderFileSize);
+        auto* header = static_cast<FlightRecorderHeader*>(memory);
+        header->magic = kFlightRecorderMagic;
+        header->version = kFlightRecorderVersion;
+        header->slotCount = static_cast<std::uint32_t>(kFlightRecorderSlotCount);
+
+        mappedHeader_.store(header, std::memory_order_release);
+    }
+
+    void Record(LogRecordKind kind, std::string_view payload) {
+        FlightRecorderHeader* header = mappedHeader_.load(std::memory_order_acquire);
+        if (!header) {
+            return;
+        }
+
+        std::uint64_t sequence = std::atomic_ref(header->nextSequence).fetch_add(1, std::memory_order_relaxed) + 1;
+        FlightRecorderSlot& slot = GetSlots(header)[(sequence - 1) % kFlightRecorderSlotCount];
+
+        std::atomic_ref(slot.sequence).store(0, std::memory_order_relaxed);
+        std::size_t length = (std::min)(payload.size(), sizeof(slot.payload));
+        slot.kind = kind;
+        slot.length = static_cast<std::uint16_t>(length);
+        std::memcpy(slot.payload, payload.data(), length);
+        std::atomic_ref(slot.sequence).store(sequence, std::memory_order_release);
+    }
+
+    std::uint64_t Sequence() const {
+        FlightRecorderHeader* header = mappedHeader_.load(std::memory_order_acquire);
+        return header ? std::atomic_ref(header->nextSequence).load(std::memory_order_acquire) : 0;
+    }
+
+    // Writer thread: records up to sequence are now in the log files.
+    void MarkPersisted(std::uint64_t sequence) {
+        FlightRecorderHeader* header = mappedHeader_.load(std::memory_order_acquire);
+        if (header && header->persistedSequence != sequence) {
+            std::atomic_ref(header->persistedSequence).store(sequence, std::memory_order_release);
+        }
+    }
+
+    void MarkClean() {
+        if (FlightRecorderHeader* header = mappedHeader_.load(std::memory_order_acquire)) {
+            std::atomic_ref(header->cleanShutdown).store(1, std::memory_order_release);
+        }
+    }
+
+    // Header of a recorder file, or nothing if it is missing, truncated or
+    // written by another format version.
+    static std::optional<FlightRecorderHeader> ReadHeader(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        FlightRecorderHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kFlightRecorderMagic ||
+            header.version != kFlightRecorderVersion || header.slotCount != kFlightRecorderSlotCount ||
+            std::filesystem::file_size(path) < kFlightRecorderFileSize) {
+            return std::nullopt;
+        }
+        return header;
+    }
+
+    // True if the session that wrote header ended with records the writer
+    // thread never flushed.
+    static bool LeftUnflushedRecords(const FlightRecorderHeader& header) {
+        return header.cleanShutdown == 0 && header.nextSequence > header.persistedSequence;
+    }
+
+    // Every record still held by a recorder file, oldest first, rendered as log lines.
+    static std::vector<std::string> ReadTail(const std::filesystem::path& path, LogChannel channel) {
+        std::vector<std::string> lines;
+
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> data(kFlightRecorderFileSize);
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+            return lines;
+        }
+
+        std::vector<FlightRecorderSlot> slots(kFlightRecorderSlotCount);
+        std::memcpy(slots.data(), data.data() + kFlightRecorderSlotSize, slots.size() * sizeof(FlightRecorderSlot));
+        std::erase_if(slots, [](const FlightRecorderSlot& slot) { return slot.sequence == 0; });
+        std::sort(slots.begin(), slots.end(),
+                  [](const FlightRecorderSlot& a, const FlightRecorderSlot& b) { return a.sequence < b.sequence; });
+
+        lines.reserve(slots.size());
+        for (const auto& slot : slots) {
+            std::size_t length = (std::min)(static_cast<std::size_t>(slot.length), sizeof(slot.payload));
+            if (slot.kind == LogRecordKind::Deferred) {
+                if (length != sizeof(DeferredLogRecord)) {
+                    continue;
+                }
+                DeferredLogRecord record;
+                std::memcpy(&record, slot.payload, sizeof(record));
+
+                char line[kLogRecordTextSize];
+                lines.emplace_back(line, RenderDeferredLogLine(line, channel, record));
+            } else {
+                lines.emplace_back(slot.payload, length);
+            }
+        }
+
+        return lines;
+    }
+
+    // Rebuilds the ordered tail of a recorder file left behind by a session
+    // that ended with unflushed records. Returns no lines otherwise.
+    static std::vector<std::string> ReadCrashTail(const std::filesystem::path& path, LogChannel channel) {
+        std::optional<FlightRecorderHeader> header = ReadHeader(path);
+        if (!header || !LeftUnflushedRecords(*header)) {
+            return {};
+        }
+        return ReadTail(path, channel);
+    }
+
+private:
+    static FlightRecorderSlot* GetSlots(FlightRecorderHeader* header) {
+        return reinterpret_cast<FlightRecorderSlot*>(reinterpret_cast<char*>(header) + kFlightRecorderSlotSize);
+    }
+
+    std::atomic<FlightRecorderHeader*> mappedHeader_{nullptr};
+};
+
+// ===== LOG INDEX =====
+inline std::filesystem::path GetLogSegmentFileName(LogChannel channel, std::size_t index, std::string_view extension) {
+    std::filesystem::path fileName = GetLogFileName(channel);
+    std::string suffix;
+    if (index != 0) {
+        suffix = '.' + std::to_string(index);
+    }
+    suffix += extension;
+    fileName.replace_extension(suffix);
+    return fileName;
+}
+
+// Rotated segments sit next to the live file: "BWY-multi-Fix-NG-Quest.1.log"
+// is the most recent one, higher indices are older.
+inline std::filesystem::path GetLogSegmentPath(const std::filesystem::path& directory, LogChannel channel,
+                                               std::size_t index) {
+    return directory / GetLogSegmentFileName(channel, index, ".log");
+}
+
+// Sidecar index next to each primary log segment: "X.idx" for the live file,
+// "X.N.idx" for rotated ones. It is a flat array of LogIndexEntry records, one
+// per flushed batch plus one per banner event, so a reader can find a time
+// window or a quest milestone without scanning the text.
+inline std::filesystem::path GetLogIndexPath(const std::filesystem::path& directory, LogChannel channel,
+                                             std::size_t index) {
+    return directory / GetLogSegmentFileName(channel, index, ".idx");
+}
+
+// Binary deferred log next to each primary log segment, numbered the same way:
+// "X.blog" for the live file, "X.N.blog" for rotated ones.
+inline std::filesystem::path GetBinaryLogPath(const std::filesystem::path& directory, LogChannel channel,
+                                              std::size_t index) {
+    return directory / GetLogSegmentFileName(channel, index, ".blog");
+}
+
+// Deletes the rotated segments, indexes and binary logs an earlier session
+// left behind, so the retained history only ever covers the current session.
+// The live files are left to the caller.
+inline void RemoveRotatedLogSegments(const std::filesystem::path& directory, LogChannel channel) {
+    for (std::size_t index = 1;; ++index) {
+        bool found = false;
+        for (const auto& path : {GetLogSegmentPath(directory, channel, index),
+                                 GetLogIndexPath(directory, channel, index),
+                                 GetBinaryLogPath(directory, channel, index)}) {
+            std::error_code ec;
+            if (std::filesystem::exists(path, ec)) {
+                found = true;
+                std::filesystem::remove(path, ec);
+            }
+        }
+        if (!found) {
+            return;
+        }
+    }
+}
+
+constexpr std::uint16_t kLogIndexBatchEvent = 0xFFFF;
+constexpr std::uint8_t kLogIndexBinary = 0x01;
+
+struct LogIndexEntry {
+    std::int64_t firstTimestampMs;
+    std::int64_t lastTimestampMs;
+    std::uint64_t offset;  // byte offset in the matching .log segment, or .blog with kLogIndexBinary
+    std::uint32_t length;
+    std::uint16_t event;  // kLogIndexBatchEvent or the banner's LogFormatId
+    std::uint8_t channel;
+    std::uint8_t flags;
+};
+
+static_assert(sizeof(LogIndexEntry) == 32, "Log index entries are written raw and must stay 32 bytes");
+
+// Lines drained from one channel, waiting to be written as a single batch,
+// together with the index entries for the banner events among them.
+struct LogBatch {
+    std::string text;
+    std::size_t lines = 0;  // text lines plus binary records; segments rotate on this count
+    std::int64_t firstTimestampMs = 0;
+    std::int64_t lastTimestampMs = 0;
+    std::vector<LogIndexEntry> index;
+    // With binaryDeferred set, deferred records are encoded into binary for the
+    // .blog file instead of being rendered into text. They are indexed like
+    // text lines, with kLogIndexBinary entries pointing into binary.
+    bool binaryDeferred = false;
+    std::string binary;
+    std::int64_t binaryFirstTimestampMs = 0;
+    std::int64_t binaryLastTimestampMs = 0;
+    BinaryLogEncoder encoder;
+
+    void Append(LogChannel channel, LogRecordKind kind, std::int64_t timestampMs, std::string_view payload) {
+        if (binaryDeferred && kind == LogRecordKind::Deferred) {
+            if (payload.size() == sizeof(DeferredLogRecord)) {
+                AppendBinary(channel, timestampMs, payload);
+            }
+            return;
+        }
+
+        if (text.empty()) {
+            firstTimestampMs = timestampMs;
+        }
+        lastTimestampMs = (std::max)(lastTimestampMs, timestampMs);
+
+        if (kind == LogRecordKind::Deferred) {
+            if (payload.size() != sizeof(DeferredLogRecord)) {
+                return;
+            }
+            DeferredLogRecord record;
+            std::memcpy(&record, payload.data(), sizeof(record));
+
+            char line[kLogRecordTextSize];
+            std::size_t length = RenderDeferredLogLine(line, channel, record);
+            if (IsIndexedLogFormat(record.format)) {
+                index.push_back({timestampMs, timestampMs, text.size(), static_cast<std::uint32_t>(length),
+                                 static_cast<std::uint16_t>(record.format), static_cast<std::uint8_t>(channel), 0});
+            }
+            AppendLine(std::string_view(line, length));
+        } else {
+            AppendLine(payload);
+        }
+    }
+
+    void AppendLine(std::string_view line) {
+        text.append(line);
+        text.push_back('\n');
+        lines++;
+    }
+
+    void AppendBinary(LogChannel channel, std::int64_t timestampMs, std::string_view payload) {
+        DeferredLogRecord record;
+        std::memcpy(&record, payload.data(), sizeof(record));
+
+        if (binary.empty()) {
+            binaryFirstTimestampMs = timestampMs;
+        }
+        binaryLastTimestampMs = (std::max)(binaryLastTimestampMs, timestampMs);
+
+        std::size_t offset = binary.size();
+        encoder.Append(binary, channel, record);
+        if (IsIndexedLogFormat(record.format)) {
+            index.push_back({timestampMs, timestampMs, offset, static_cast<std::uint32_t>(binary.size() - offset),
+                             static_cast<std::uint16_t>(record.format), static_cast<std::uint8_t>(channel),
+                             kLogIndexBinary});
+        }
+        lines++;
+    }
+
+    // Adds the entries covering the whole text and binary parts of the batch
+    // and returns the index entries to write with it; their offsets are
+    // relative to the start of text, or of binary for kLogIndexBinary entries.
+    std::span<LogIndexEntry> Seal(LogChannel channel) {
+        if (!text.empty()) {
+            index.push_back({firstTimestampMs, lastTimestampMs, 0, static_cast<std::uint32_t>(text.size()),
+                             kLogIndexBatchEvent, static_cast<std::uint8_t>(channel), 0});
+        }
+        if (!binary.empty()) {
+            index.push_back({binaryFirstTimestampMs, binaryLastTimestampMs, 0,
+                             static_cast<std::uint32_t>(binary.size()), kLogIndexBatchEvent,
+                             static_cast<std::uint8_t>(channel), kLogIndexBinary});
+        }
+        return index;
+    }
+
+    void Clear() {
+        text.clear();
+        binary.clear();
+        lines = 0;
+        lastTimestampMs = 0;
+        binaryLastTimestampMs = 0;
+        index.clear();
+    }
+};
+
+inline std::vector<LogIndexEntry> ReadLogIndex(const std::filesystem::path& path) {
+    std::vector<LogIndexEntry> entries;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    std::ifstream file(path, std::ios::binary);
+    if (ec || !file.is_open()) {
+        return entries;
+    }
+
+    entries.resize(size / sizeof(LogIndexEntry));
+    file.read(reinterpret_cast<char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(LogIndexEntry)));
+    entries.resize(static_cast<std::size_t>(file.gcount()) / sizeof(LogIndexEntry));
+    return entries;
+}
+
+// Parses the local time at the start of "YYYY-MM-DD HH:MM:SS[.mmm]" into
+// milliseconds since the epoch. The last second converted is cached, as
+// consecutive log lines almost always share it.
+inline std::optional<std::int64_t> ParseLogTimestamp(std::string_view text) {
+    if (text.size() < kTimestampPrefixLength) {
+        return std::nullopt;
+    }
+
+    thread_local char cachedPrefix[kTimestampPrefixLength] = {};
+    thread_local std::int64_t cachedSecondMs = 0;
+
+    if (std::memcmp(cachedPrefix, text.data(), kTimestampPrefixLength) != 0) {
+        auto field = [text](std::size_t offset, std::size_t length, int& value) {
+            const char* begin = text.data() + offset;
+            return std::from_chars(begin, begin + length, value).ptr == begin + length;
+        };
+        std::tm local{};
+        if (!field(0, 4, local.tm_year) || !field(5, 2, local.tm_mon) || !field(8, 2, local.tm_mday) ||
+            !field(11, 2, local.tm_hour) || !field(14, 2, local.tm_min) || !field(17, 2, local.tm_sec)) {
+            return std::nullopt;
+        }
+        local.tm_year -= 1900;
+        local.tm_mon -= 1;
+        local.tm_isdst = -1;
+
+        std::time_t seconds = std::mktime(&local);
+        if (seconds == static_cast<std::time_t>(-1)) {
+            return std::nullopt;
+        }
+        std::memcpy(cachedPrefix, text.data(), kTimestampPrefixLength);
+        cachedSecondMs = static_cast<std::int64_t>(seconds) * 1000;
+    }
+
+    int millis = 0;
+    if (text.size() >= kTimestampLength && text[kTimestampPrefixLength] == '.') {
+        const char* begin = text.data() + kTimestampPrefixLength + 1;
+        std::from_chars(begin, begin + 3, millis);
+    }
+    return cachedSecondMs + millis;
+}
+
+struct LogQueryLine {
+    std::int64_t timestampMs;
+    LogChannel channel;
+    std::string text;
+};
+
+struct LogEventHit {
+    std::int64_t timestampMs;
+    LogChannel channel;
+    LogFormatId event;
+};
+
+// Calls fn(segment, logPath, indexEntries) for every segment that has both a
+// log and an index, oldest rotated segment first and the live one (0) last.
+template <class Fn>
+void ForEachIndexedLogSegment(const std::filesystem::path& directory, LogChannel channel, Fn&& fn) {
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> segments;
+    for (std::size_t index = 0;; ++index) {
+        std::filesystem::path logPath = index == 0 ? directory / GetLogFileName(channel)
+                                                   : GetLogSegmentPath(directory, channel, index);
+        std::filesystem::path indexPath = GetLogIndexPath(directory, channel, index);
+        std::error_code ec;
+        if (!std::filesystem::exists(logPath, ec) || !std::filesystem::exists(indexPath, ec)) {
+            break;
+        }
+        segments.emplace_back(std::move(logPath), std::move(indexPath));
+    }
+
+    for (std::size_t index = segments.size(); index > 0; --index) {
+        fn(index - 1, segments[index - 1].first, ReadLogIndex(segments[index - 1].second));
+    }
+}
+
+// Every indexed banner event of the given kind across all channels and
+// segments, oldest first. Reads only the index files.
+inline std::vector<LogEventHit> FindLogEvents(const std::filesystem::path& directory, LogFormatId event) {
+    std::vector<LogEventHit> hits;
+    for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+        auto channel = static_cast<LogChannel>(i);
+        ForEachIndexedLogSegment(
+            directory, channel,
+            [&](std::size_t, const std::filesystem::path&, const std::vector<LogIndexEntry>& entries) {
+                for (const auto& entry : entries) {
+                    if (entry.event == static_cast<std::uint16_t>(event)) {
+                        hits.push_back({entry.firstTimestampMs, channel, event});
+                    }
+                }
+            });
+    }
+    std::stable_sort(hits.begin(), hits.end(),
+                     [](const LogEventHit& a, const LogEventHit& b) { return a.timestampMs < b.timestampMs; });
+    return hits;
+}
+
+// Lines of all three channels stamped within [fromMs, toMs], merged by time.
+// Only the batches whose index range overlaps the window are read; binary
+// batches are decoded from the segment's .blog and rendered like the text the
+// writer would have produced. A line without its own timestamp takes the one
+// before it.
+inline std::vector<LogQueryLine> QueryLogWindow(const std::filesystem::path& directory, std::int64_t fromMs,
+                                                std::int64_t toMs) {
+    std::vector<LogQueryLine> lines;
+    std::string batch;
+
+    auto readBatch = [&batch](std::ifstream& file, const LogIndexEntry& entry) {
+        batch.resize(entry.length);
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(entry.offset));
+        file.read(batch.data(), static_cast<std::streamsize>(batch.size()));
+        batch.resize(static_cast<std::size_t>(file.gcount()));
+    };
+    auto addRecord = [&lines, fromMs, toMs](LogChannel channel, const DeferredLogRecord& record) {
+        if (record.timestampMs >= fromMs && record.timestampMs <= toMs) {
+            char line[kLogRecordTextSize];
+            std::size_t length = RenderDeferredLogLine(line, channel, record);
+            lines.push_back({record.timestampMs, channel, std::string(line, length)});
+        }
+    };
+
+    for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+        auto channel = static_cast<LogChannel>(i);
+        ForEachIndexedLogSegment(
+            directory, channel,
+            [&](std::size_t segment, const std::filesystem::path& logPath, const std::vector<LogIndexEntry>& entries) {
+                std::ifstream file(logPath, std::ios::binary);
+                std::ifstream binaryFile;
+                for (const auto& entry : entries) {
+                    if (entry.event != kLogIndexBatchEvent || entry.lastTimestampMs < fromMs ||
+                        entry.firstTimestampMs > toMs) {
+                        continue;
+                    }
+
+                    if ((entry.flags & kLogIndexBinary) != 0) {
+                        if (!binaryFile.is_open()) {
+                            binaryFile.open(GetBinaryLogPath(directory, channel, segment), std::ios::binary);
+                        }
+                        readBatch(binaryFile, entry);
+                        DecodeBinaryLogChunk(batch, channel, entry.firstTimestampMs, addRecord);
+                        continue;
+                    }
+
+                    readBatch(file, entry);
+
+                    std::int64_t timestampMs = entry.firstTimestampMs;
+                    std::string_view rest = batch;
+                    while (!rest.empty()) {
+                        std::size_t end = rest.find('\n');
+                        std::string_view line = rest.substr(0, end);
+                        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+
+                        if (line.size() > 1 && line.front() == '[') {
+                            timestampMs = ParseLogTimestamp(line.substr(1)).value_or(timestampMs);
+                        }
+                        if (timestampMs >= fromMs && timestampMs <= toMs) {
+                            lines.push_back({timestampMs, channel, std::string(line)});
+                        }
+                    }
+                }
+            });
+    }
+
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const LogQueryLine& a, const LogQueryLine& b) { return a.timestampMs < b.timestampMs; });
+    return lines;
+}
+
+// ===== CONFIGURATION =====
+// One quest fix: once QuestEditorID reaches TriggerStage and the player holds every RequiredItems entry
+// ("Plugin.esp|LocalID", comma separated), the quest is moved to CompletionStage after DelayMs.
+// [Quest]/[Item]/[Messages] describe the original fix; each [Fix.N] section adds one more.
+struct FixRuleConfig {
+    std::string name;
+    bool enabled = true;
+    std::string questEditorID;
+    std::string questPlugin;
+    int triggerStage = 0;
+    int completionStage = 0;
+    std::string requiredItems;
+    std::string itemName;
+    bool removeItems = true;
+    int delayMs = 5000;
+    std::string triggerMessage;
+    std::string detectionMessage;
+    std::string completionMessage;
+    bool showNotification = true;
+};
+
+struct PluginConfig {
+    struct {
+        bool enabled = true;
+        std::string questEditorID = "YW_Quest_MDF";
+        std::string questPlugin = "YurianaWench.esp";
+        int triggerStage = 21;
+        int completionStage = 30;
+        bool showNotification = true;
+    } quest;
+
+    struct {
+        bool enabled = true;
+        std::string itemID = "625C7C";
+        std::string itemPlugin = "YurianaWench.esp";
+        std::string itemName = "Lelyna's Remedy";
+        bool removeOnDetection = true;
+        bool showNotification = true;
+    } item;
+
+    struct {
+        bool enabled = true;
+        std::string triggerMessage = "You must craft Lelyna's Remedy to cure Elora. Check your inventory for the recipe.";
+        std::string completionMessage = "You have crafted the potion and the temple girls are very happy. You have saved Elora!";
+        bool showTriggerMessage = true;
+        bool showCompletionMessage = true;
+    } messages;
+
+    struct {
+        bool enabled = true;
+        int checkIntervalMs = 1000;
+        float maxDetectionDistance = 5000.0f;
+    } monitoring;
+
+    struct {
+        bool enabled = true;
+    } notification;
+
+    struct {
+        int segmentMaxLines = 2500;
+        int retainedSegments = 3;
+        std::string secondaryMirror = "Sync";
+        bool actionsLog = true;
+        bool questLog = true;
+        bool systemLog = true;
+        std::string level = "info";
+        bool writeIndex = true;
+        bool binaryLog = false;
+    } logging;
+
+    std::vector<FixRuleConfig> fixes;
+};
+
+// ===== INI SCHEMA =====
+// Every INI setting, in file order. ParseConfiguration and
+// WriteDefaultConfiguration are both driven by this table, and the defaults
+// written to a new file come from PluginConfig's member initializers.
+enum class IniValueType : std::uint8_t {
+    Bool,
+    Int,
+    Float,
+    String
+};
+
+struct IniField {
+    std::string_view section;
+    std::string_view key;
+    IniValueType type;
+    void* (*bind)(PluginConfig&);
+};
+
+constexpr std::array kIniFields = {
+    IniField{"Quest", "Enabled", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.quest.enabled; }},
+    IniField{"Quest", "QuestEditorID", IniValueType::String, [](PluginConfig& c) -> void* { return &c.quest.questEditorID; }},
+    IniField{"Quest", "QuestPlugin", IniValueType::String, [](PluginConfig& c) -> void* { return &c.quest.questPlugin; }},
+    IniField{"Quest", "TriggerStage", IniValueType::Int, [](PluginConfig& c) -> void* { return &c.quest.triggerStage; }},
+    IniField{"Quest", "CompletionStage", IniValueType::Int, [](PluginConfig& c) -> void* { return &c.quest.completionStage; }},
+    IniField{"Quest", "ShowNotification", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.quest.showNotification; }},
+
+    IniField{"Item", "Enabled", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.item.enabled; }},
+    IniField{"Item", "ItemID", IniValueType::String, [](PluginConfig& c) -> void* { return &c.item.itemID; }},
+    IniField{"Item", "ItemPlugin", IniValueType::String, [](PluginConfig& c) -> void* { return &c.item.itemPlugin; }},
+    IniField{"Item", "ItemName", IniValueType::String, [](PluginConfig& c) -> void* { return &c.item.itemName; }},
+    IniField{"Item", "RemoveOnDetection", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.item.removeOnDetection; }},
+    IniField{"Item", "ShowNotification", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.item.showNotification; }},
+
+    IniField{"Messages", "Enabled", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.messages.enabled; }},
+    IniField{"Messages", "TriggerMessage", IniValueType::String, [](PluginConfig& c) -> void* { return &c.messages.triggerMessage; }},
+    IniField{"Messages", "CompletionMessage", IniValueType::String, [](PluginConfig& c) -> void* { return &c.messages.completionMessage; }},
+    IniField{"Messages", "ShowTriggerMessage", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.messages.showTriggerMessage; }},
+    IniField{"Messages", "ShowCompletionMessage", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.messages.showCompletionMessage; }},
+
+    IniField{"Monitoring", "Enabled", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.monitoring.enabled; }},
+    IniField{"Monitoring", "CheckIntervalMs", IniValueType::Int, [](PluginConfig& c) -> void* { return &c.monitoring.checkIntervalMs; }},
+    IniField{"Monitoring", "MaxDetectionDistance", IniValueType::Float, [](PluginConfig& c) -> void* { return &c.monitoring.maxDetectionDistance; }},
+
+    IniField{"Notification", "Enabled", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.notification.enabled; }},
+
+    IniField{"Logging", "SegmentMaxLines", IniValueType::Int, [](PluginConfig& c) -> void* { return &c.logging.segmentMaxLines; }},
+    IniField{"Logging", "RetainedSegments", IniValueType::Int, [](PluginConfig& c) -> void* { return &c.logging.retainedSegments; }},
+    IniField{"Logging", "SecondaryMirror", IniValueType::String, [](PluginConfig& c) -> void* { return &c.logging.secondaryMirror; }},
+    IniField{"Logging", "ActionsLog", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.logging.actionsLog; }},
+    IniField{"Logging", "QuestLog", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.logging.questLog; }},
+    IniField{"Logging", "SystemLog", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.logging.systemLog; }},
+    IniField{"Logging", "Level", IniValueType::String, [](PluginConfig& c) -> void* { return &c.logging.level; }},
+    IniField{"Logging", "WriteIndex", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.logging.writeIndex; }},
+    IniField{"Logging", "BinaryLog", IniValueType::Bool, [](PluginConfig& c) -> void* { return &c.logging.binaryLog; }},
+};
+
+// Perfect hash over "section.key": the seed is searched at compile time so
+// that every field lands in its own bucket, and a lookup is one hash, one
+// table read and one string compare. The hash only mixes the two lengths and
+// a few characters, which is enough to tell the fields apart (the seed search
+// fails the build if it ever is not) and keeps a lookup cheaper than the
+// compare-and-skip of a linear scan.
+constexpr std::size_t kIniHashBuckets = 256;
+constexpr std::uint8_t kIniHashEmpty = 0xFF;
+
+static_assert(kIniFields.size() < kIniHashEmpty, "Too many INI fields for the hash table");
+
+constexpr std::uint32_t HashIniKey(std::string_view section, std::string_view key, std::uint32_t seed) {
+    std::uint32_t hash = seed;
+    auto mix = [&hash](std::uint32_t value) { hash = (hash ^ value) * 0x9E3779B1u; };
+    mix(static_cast<std::uint32_t>(section.size() << 8 | key.size()));
+    if (!section.empty()) {
+        mix(static_cast<std::uint8_t>(section.front()));
+    }
+    if (!key.empty()) {
+        mix(static_cast<std::uint32_t>(static_cast<std::uint8_t>(key.front())) << 16 |
+            static_cast<std::uint32_t>(static_cast<std::uint8_t>(key[key.size() / 2])) << 8 |
+            static_cast<std::uint8_t>(key.back()));
+    }
+    return hash ^ (hash >> 16);
+}
+
+constexpr std::uint32_t FindIniHashSeed() {
+    for (std::uint32_t seed = 1; seed < 1000; ++seed) {
+        std::array<bool, kIniHashBuckets> used{};
+        bool collision = false;
+        for (const auto& field : kIniFields) {
+            auto bucket = HashIniKey(field.section, field.key, seed) % kIniHashBuckets;
+            if (used[bucket]) {
+                collision = true;
+                break;
+            }
+            used[bucket] = true;
+        }
+        if (!collision) {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+constexpr std::uint32_t kIniHashSeed = FindIniHashSeed();
+static_assert(kIniHashSeed != 0, "No collision-free seed for the INI key hash");
+
+constexpr std::array<std::uint8_t, kIniHashBuckets> BuildIniHashTable() {
+    std::array<std::uint8_t, kIniHashBuckets> table{};
+    table.fill(kIniHashEmpty);
+    for (std::size_t i = 0; i < kIniFields.size(); ++i) {
+        table[HashIniKey(kIniFields[i].section, kIniFields[i].key, kIniHashSeed) % kIniHashBuckets] =
+            static_cast<std::uint8_t>(i);
+    }
+    return table;
+}
+
+constexpr auto kIniHashTable = BuildIniHashTable();
+
+inline const IniField* FindIniField(std::string_view section, std::string_view key) {
+    std::uint8_t index = kIniHashTable[HashIniKey(section, key, kIniHashSeed) % kIniHashBuckets];
+    if (index == kIniHashEmpty) {
+        return nullptr;
+    }
+    const IniField& field = kIniFields[index];
+    return (field.section == section && field.key == key) ? &field : nullptr;
+}
+
+// Keys of a [Fix.N] section. Rule sections are few and short, so a linear
+// scan is enough here.
+constexpr std::string_view kFixSectionPrefix = "Fix.";
+
+struct IniRuleField {
+    std::string_view key;
+    IniValueType type;
+    void* (*bind)(FixRuleConfig&);
+};
+
+constexpr std::array kFixRuleFields = {
+    IniRuleField{"Enabled", IniValueType::Bool, [](FixRuleConfig& r) -> void* { return &r.enabled; }},
+    IniRuleField{"QuestEditorID", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.questEditorID; }},
+    IniRuleField{"QuestPlugin", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.questPlugin; }},
+    IniRuleField{"TriggerStage", IniValueType::Int, [](FixRuleConfig& r) -> void* { return &r.triggerStage; }},
+    IniRuleField{"CompletionStage", IniValueType::Int, [](FixRuleConfig& r) -> void* { return &r.completionStage; }},
+    IniRuleField{"RequiredItems", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.requiredItems; }},
+    IniRuleField{"ItemName", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.itemName; }},
+    IniRuleField{"RemoveItems", IniValueType::Bool, [](FixRuleConfig& r) -> void* { return &r.removeItems; }},
+    IniRuleField{"DelayMs", IniValueType::Int, [](FixRuleConfig& r) -> void* { return &r.delayMs; }},
+    IniRuleField{"TriggerMessage", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.triggerMessage; }},
+    IniRuleField{"DetectionMessage", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.detectionMessage; }},
+    IniRuleField{"CompletionMessage", IniValueType::String, [](FixRuleConfig& r) -> void* { return &r.completionMessage; }},
+    IniRuleField{"ShowNotification", IniValueType::Bool, [](FixRuleConfig& r) -> void* { return &r.showNotification; }},
+};
+
+inline const IniRuleField* FindFixRuleField(std::string_view key) {
+    auto it = std::find_if(kFixRuleFields.begin(), kFixRuleFields.end(),
+                           [key](const IniRuleField& field) { return field.key == key; });
+    return it != kFixRuleFields.end() ? &*it : nullptr;
+}
+
+inline std::string_view TrimIniText(std::string_view text) {
+    auto first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    auto last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+// Case-insensitive comparison of an INI value against a lower-case word.
+inline bool IniValueEquals(std::string_view value, std::string_view lowerWord) {
+    return value.size() == lowerWord.size() &&
+           std::equal(value.begin(), value.end(), lowerWord.begin(), [](char c, char lower) {
+               return (c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c) == lower;
+           });
+}
+
+// Stores value into target; returns false and leaves target unchanged when
+// the value does not parse as type. Bools are 0/1/true/false in any case.
+inline bool ParseIniValue(IniValueType type, void* target, std::string_view value) {
+    switch (type) {
+        case IniValueType::Bool:
+            if (value == "1" || IniValueEquals(value, "true")) {
+                *static_cast<bool*>(target) = true;
+            } else if (value == "0" || IniValueEquals(value, "false")) {
+                *static_cast<bool*>(target) = false;
+            } else {
+                return false;
+            }
+            return true;
+        case IniValueType::Int: {
+            int parsed = 0;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+            if (error != std::errc() || end != value.data() + value.size()) {
+                return false;
+            }
+            *static_cast<int*>(target) = parsed;
+            return true;
+        }
+        case IniValueType::Float: {
+            float parsed = 0.0f;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+            if (error != std::errc() || end != value.data() + value.size()) {
+                return false;
+            }
+            *static_cast<float*>(target) = parsed;
+            return true;
+        }
+        default:
+            static_cast<std::string*>(target)->assign(value);
+            return true;
+    }
+}
+
+inline std::string FormatIniValue(IniValueType type, const void* source) {
+    switch (type) {
+        case IniValueType::Bool:
+            return *static_cast<const bool*>(source) ? "true" : "false";
+        case IniValueType::Int:
+            return std::to_string(*static_cast<const int*>(source));
+        case IniValueType::Float: {
+            char text[32];
+            auto result = std::to_chars(text, text + sizeof(text), *static_cast<const float*>(source),
+                                        std::chars_format::fixed, 1);
+            return std::string(text, result.ptr);
+        }
+        default:
+            return *static_cast<const std::string*>(source);
+    }
+}
+
+// Receives a recognised key whose value did not parse, with the setting that
+// was kept instead.
+using IniWarningHandler = void (*)(std::string_view section, std::string_view key, std::string_view value,
+                                   const std::string& kept);
+
+// Applies every recognised "key=value" line of an INI document to config.
+// Unknown keys are ignored; malformed values keep the current setting and
+// are reported to onInvalid.
+inline void ParseConfiguration(std::string_view text, PluginConfig& config, IniWarningHandler onInvalid = nullptr) {
+    std::string_view currentSection;
+    FixRuleConfig* currentRule = nullptr;
+
+    while (!text.empty()) {
+        auto lineEnd = text.find('\n');
+        std::string_view line = TrimIniText(text.substr(0, lineEnd));
+        text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+
+        if (line.empty() || line[0] == ';' || line[0] == '#') {
+            continue;
+        }
+
+        if (line.front() == '[' && line.back() == ']') {
+            currentSection = line.substr(1, line.size() - 2);
+            currentRule = nullptr;
+            if (currentSection.starts_with(kFixSectionPrefix)) {
+                auto it = std::find_if(config.fixes.begin(), config.fixes.end(),
+                                       [&](const FixRuleConfig& rule) { return rule.name == currentSection; });
+                if (it == config.fixes.end()) {
+                    it = config.fixes.emplace(config.fixes.end());
+                    it->name = currentSection;
+                }
+                currentRule = &*it;
+            }
+            continue;
+        }
+
+        auto equalPos = line.find('=');
+        if (equalPos == std::string_view::npos) {
+            continue;
+        }
+
+        std::string_view key = TrimIniText(line.substr(0, equalPos));
+        std::string_view value = TrimIniText(line.substr(equalPos + 1));
+
+        if (currentRule) {
+            const IniRuleField* field = FindFixRuleField(key);
+            if (field && !ParseIniValue(field->type, field->bind(*currentRule), value) && onInvalid) {
+                onInvalid(currentSection, key, value, FormatIniValue(field->type, field->bind(*currentRule)));
+            }
+            continue;
+        }
+
+        const IniField* field = FindIniField(currentSection, key);
+        if (field && !ParseIniValue(field->type, field->bind(config), value) && onInvalid) {
+            onInvalid(currentSection, key, value, FormatIniValue(field->type, field->bind(config)));
+        }
+    }
+}
+
+struct RequiredItemRef {
+    std::string_view plugin;
+    std::string_view localID;
+};
+
+// Splits "Plugin.esp|625C7C, Other.esp|XX0012AB" into plugin/local ID pairs;
+// entries without a '|' are ignored.
+inline std::vector<RequiredItemRef> ParseRequiredItems(std::string_view text) {
+    std::vector<RequiredItemRef> items;
+    while (!text.empty()) {
+        auto comma = text.find(',');
+        std::string_view entry = TrimIniText(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+        auto bar = entry.find('|');
+        if (bar == std::string_view::npos) {
+            continue;
+        }
+        items.push_back({TrimIniText(entry.substr(0, bar)), TrimIniText(entry.substr(bar + 1))});
+    }
+    return items;
+}
+
+// The legacy [Quest]/[Item]/[Messages] fix followed by every [Fix.N] rule.
+inline std::vector<FixRuleConfig> CollectFixRules(const PluginConfig& config) {
+    std::vector<FixRuleConfig> rules;
+    rules.reserve(config.fixes.size() + 1);
+
+    FixRuleConfig& legacy = rules.emplace_back();
+    legacy.name = "Quest";
+    legacy.enabled = config.quest.enabled;
+    legacy.questEditorID = config.quest.questEditorID;
+    legacy.questPlugin = config.quest.questPlugin;
+    legacy.triggerStage = config.quest.triggerStage;
+    legacy.completionStage = config.quest.completionStage;
+    if (config.item.enabled) {
+        legacy.requiredItems = config.item.itemPlugin + "|" + config.item.itemID;
+    }
+    legacy.itemName = config.item.itemName;
+    legacy.removeItems = config.item.removeOnDetection;
+    legacy.showNotification = config.notification.enabled && config.quest.showNotification;
+    legacy.detectionMessage = "BWY FIX: Potion detected to cure the priestess. Wait for Yulia to take it.";
+    if (config.messages.enabled && config.messages.showTriggerMessage) {
+        legacy.triggerMessage = config.messages.triggerMessage;
+    }
+    if (config.messages.enabled && config.messages.showCompletionMessage) {
+        legacy.completionMessage = config.messages.completionMessage;
+    }
+
+    for (const auto& rule : config.fixes) {
+        FixRuleConfig& added = rules.emplace_back(rule);
+        added.showNotification = config.notification.enabled && rule.showNotification;
+    }
+    return rules;
+}
+
+// Writes every setting with its default value, in schema order, followed by a
+// commented-out [Fix.N] template. This is what a new INI file contains.
+inline void WriteDefaultConfiguration(std::ostream& out) {
+    PluginConfig defaults;
+    std::string_view currentSection;
+
+    for (const auto& field : kIniFields) {
+        if (field.section != currentSection) {
+            if (!currentSection.empty()) {
+                out << '\n';
+            }
+            out << "[" << field.section << "]\n";
+            currentSection = field.section;
+        }
+        out << field.key << "=" << FormatIniValue(field.type, field.bind(defaults)) << '\n';
+    }
+
+    FixRuleConfig ruleDefaults;
+    out << '\n';
+    out << "; Additional fixes: add one [Fix.N] section per quest, for example:\n";
+    out << "; [" << kFixSectionPrefix << "1]\n";
+    for (const auto& field : kFixRuleFields) {
+        out << "; " << field.key << "=" << FormatIniValue(field.type, field.bind(ruleDefaults)) << '\n';
+    }
+}
+
+// ===== CONFIGURATION SNAPSHOTS =====
+// Immutable snapshots published through one shared pointer. Readers take a
+// counted reference and keep the snapshot alive while they hold it; a writer
+// publishes a complete new snapshot. A retired snapshot is freed when the
+// last reader holding it lets go, so reloading never piles up old snapshots
+// and a reader is never left dangling. The pointer is guarded by a spin flag
+// held only to copy or swap it, so a reader never waits on a writer's parse
+// or on a thread asleep in a lock. std::atomic<std::shared_ptr> works the
+// same way, but the libstdc++ 12 load drops its lock bit with relaxed order,
+// a race TSan reports.
+template <class T>
+class SnapshotPublisher {
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    SnapshotPublisher() = default;  // Get() is null until the first Publish
+    explicit SnapshotPublisher(Snapshot initial) : current_(std::move(initial)) {}
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    Snapshot Get() const {
+        Acquire();
+        Snapshot snapshot = current_;
+        busy_.clear(std::memory_order_release);
+        return snapshot;
+    }
+
+    // The retired snapshot is released outside the flag, so freeing it never holds up a reader.
+    Snapshot Publish(Snapshot snapshot) {
+        Snapshot retired = snapshot;
+        Acquire();
+        current_.swap(retired);
+        busy_.clear(std::memory_order_release);
+        publishedCount_.fetch_add(1, std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    std::size_t PublishedCount() const { return publishedCount_.load(std::memory_order_relaxed); }
+
+private:
+    void Acquire() const {
+        while (busy_.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+
+    mutable std::atomic_flag busy_;
+    Snapshot current_;
+    std::atomic<std::size_t> publishedCount_{0};
+};
+
+// Parses an INI file into a fresh configuration; nullptr if it cannot be read.
+inline std::unique_ptr<PluginConfig> ReadConfigurationFile(const std::filesystem::path& path,
+                                                           IniWarningHandler onInvalid = nullptr) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    auto config = std::make_unique<PluginConfig>();
+    ParseConfiguration(content, *config, onInvalid);
+    return config;
+}
+
+// Turns directory change notifications into real changes of one file: they
+// also fire for its neighbours and for every step of an editor's save, so
+// only a new write time on a file that exists counts.
+class FileChangeFilter {
+public:
+    explicit FileChangeFilter(std::filesystem::path path) : path_(std::move(path)), lastWrite_(GetWriteTime(path_)) {}
+
+    bool Changed() {
+        auto currentWrite = GetWriteTime(path_);
+        std::error_code ec;
+        if (currentWrite == lastWrite_ || !std::filesystem::exists(path_, ec)) {
+            return false;
+        }
+        lastWrite_ = currentWrite;
+        return true;
+    }
+
+private:
+    static std::filesystem::file_time_type GetWriteTime(const std::filesystem::path& path) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? std::filesystem::file_time_type{} : time;
+    }
+
+    std::filesystem::path path_;
+    std::filesystem::file_time_type lastWrite_;
+};
+
+// ===== FIX RULES =====
+enum FixRuleFlags : std::uint8_t {
+    kFixRuleRemoveItems = 1 << 0,
+    kFixRuleShowNotification = 1 << 1
+};
+
+// Most container changes in the world never touch the player; the container
+// sink rejects them with this check before it reads anything else.
+constexpr bool IsPlayerInventoryChange(std::uint32_t oldContainer, std::uint32_t newContainer,
+                                       std::uint32_t playerFormID) {
+    return (newContainer == playerFormID || oldContainer == playerFormID) && newContainer != oldContainer;
+}
+
+// Open-addressing map from FormID to the rules that watch it, rebuilt with each rule table. FormID 0 marks an
+// empty slot, and the table is kept at most half full, so a miss usually costs one hash and one load.
+class FormIDIndex {
+    struct Slot {
+        std::uint32_t formID = 0;
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> rules_;
+    std::uint32_t shift_ = 32;
+
+    std::uint32_t Bucket(std::uint32_t formID) const {
+        return shift_ >= 32 ? 0 : static_cast<std::uint32_t>((formID * 2654435761u) >> shift_);
+    }
+
+public:
+    void Build(std::vector<std::pair<std::uint32_t, std::uint32_t>> entries) {
+        std::erase_if(entries, [](const auto& entry) { return entry.first == 0; });
+        std::sort(entries.begin(), entries.end());
+
+        std::uint32_t bits = 3;
+        while ((1u << bits) < entries.size() * 2) {
+            ++bits;
+        }
+        shift_ = 32 - bits;
+        slots_.assign(std::size_t{1} << bits, Slot{});
+        rules_.clear();
+        rules_.reserve(entries.size());
+
+        const std::uint32_t mask = (1u << bits) - 1;
+        for (std::size_t i = 0; i < entries.size();) {
+            Slot slot{entries[i].first, static_cast<std::uint32_t>(rules_.size()), 0};
+            for (; i < entries.size() && entries[i].first == slot.formID; ++i, ++slot.count) {
+                rules_.push_back(entries[i].second);
+            }
+            std::uint32_t bucket = Bucket(slot.formID);
+            while (slots_[bucket].formID != 0) {
+                bucket = (bucket + 1) & mask;
+            }
+            slots_[bucket] = slot;
+        }
+    }
+
+    std::span<const std::uint32_t> Find(std::uint32_t formID) const {
+        if (slots_.empty() || formID == 0) {
+            return {};
+        }
+        const std::uint32_t mask = static_cast<std::uint32_t>(slots_.size() - 1);
+        for (std::uint32_t bucket = Bucket(formID);; bucket = (bucket + 1) & mask) {
+            const Slot& slot = slots_[bucket];
+            if (slot.formID == formID) {
+                return {rules_.data() + slot.first, slot.count};
+            }
+            if (slot.formID == 0) {
+                return {};
+            }
+        }
+    }
+};
+
+// Player-held count of every watched item. Counts are seeded from the inventory, kept current from container
+// event deltas, and periodically reconciled to catch changes that raise no event. Lookups and updates are
+// lock-free, and a FormID outside the watched set costs one index miss.
+//
+// A reconcile is a scan: BeginScan, then AddBase for every base container object and AddChange for every
+// InventoryChanges entry, then CommitScan. The scan scratch is allocated once with the table, so a scan
+// never allocates; only one scan may run at a time.
+class WatchedItemCounts {
+    static constexpr std::uint32_t kNoSlot = 0xFFFFFFFF;
+
+    FormIDIndex slots_;
+    std::vector<std::uint32_t> items_;
+    std::unique_ptr<std::atomic<std::int32_t>[]> counts_;
+    std::unique_ptr<std::int32_t[]> scanCounts_;
+    std::unique_ptr<bool[]> scanSeen_;
+    mutable std::size_t scanRemaining_ = 0;
+
+    std::uint32_t SlotOf(std::uint32_t item) const {
+        auto slot = slots_.Find(item);
+        return slot.empty() ? kNoSlot : slot.front();
+    }
+
+    std::atomic<std::int32_t>* Find(std::uint32_t item) const {
+        std::uint32_t slot = SlotOf(item);
+        return slot == kNoSlot ? nullptr : &counts_[slot];
+    }
+
+public:
+    explicit WatchedItemCounts(std::vector<std::uint32_t> items) : items_(std::move(items)) {
+        std::sort(items_.begin(), items_.end());
+        items_.erase(std::unique(items_.begin(), items_.end()), items_.end());
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+        entries.reserve(items_.size());
+        for (std::uint32_t i = 0; i < items_.size(); ++i) {
+            entries.emplace_back(items_[i], i);
+        }
+        slots_.Build(std::move(entries));
+        counts_ = std::make_unique<std::atomic<std::int32_t>[]>(items_.size());
+        scanCounts_ = std::make_unique<std::int32_t[]>(items_.size());
+        scanSeen_ = std::make_unique<bool[]>(items_.size());
+    }
+
+    bool Empty() const { return items_.empty(); }
+
+    // Returns false when the item is not watched.
+    bool Apply(std::uint32_t item, std::int32_t delta) const {
+        auto* count = Find(item);
+        if (!count) {
+            return false;
+        }
+        count->fetch_add(delta, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::int32_t Count(std::uint32_t item) const {
+        auto* count = Find(item);
+        return count ? count->load(std::memory_order_relaxed) : 0;
+    }
+
+    void BeginScan() const {
+        std::fill_n(scanCounts_.get(), items_.size(), 0);
+        std::fill_n(scanSeen_.get(), items_.size(), false);
+        scanRemaining_ = items_.size();
+    }
+
+    void AddBase(std::uint32_t item, std::int32_t count) const {
+        std::uint32_t slot = SlotOf(item);
+        if (slot != kNoSlot) {
+            scanCounts_[slot] += count;
+        }
+    }
+
+    // The changes list holds each object at most once, so once this returns true every watched item has been
+    // seen and the caller can stop walking it.
+    bool AddChange(std::uint32_t item, std::int32_t countDelta) const {
+        std::uint32_t slot = SlotOf(item);
+        if (slot == kNoSlot) {
+            return false;
+        }
+        scanCounts_[slot] += countDelta;
+        if (!scanSeen_[slot]) {
+            scanSeen_[slot] = true;
+            --scanRemaining_;
+        }
+        return scanRemaining_ == 0;
+    }
+
+    // Stores the scanned counts and returns how many had drifted from the event-driven ones.
+    std::size_t CommitScan() const {
+        std::size_t drifted = 0;
+        for (std::size_t i = 0; i < items_.size(); ++i) {
+            std::int32_t actual = (std::max)(scanCounts_[i], 0);
+            if (counts_[i].exchange(actual, std::memory_order_relaxed) != actual) {
+                ++drifted;
+            }
+        }
+        return drifted;
+    }
+};
+
+enum class FixRulePhase : std::uint8_t {
+    Idle,
+    Active,
+    Triggered,
+    ItemDetected,
+    Completing,
+    Done
+};
+
+// One atomic word per rule holding its phase (low 8 bits) and the session generation that phase belongs to
+// (upper 24 bits). A word from an older session reads as Idle, so a new session resets every rule by bumping
+// the generation, and a transition from a stale session can never succeed. Phases only move by CAS, so two
+// threads racing on the same transition cannot both win it.
+class FixRulePhaseWords {
+public:
+    explicit FixRulePhaseWords(std::size_t count) : words_(std::make_unique<std::atomic<std::uint32_t>[]>(count)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            words_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    FixRulePhase Load(std::uint32_t rule, std::uint32_t generation) const {
+        return Decode(words_[rule].load(std::memory_order_acquire), generation);
+    }
+
+    bool Transition(std::uint32_t rule, FixRulePhase from, FixRulePhase to, std::uint32_t generation) {
+        std::uint32_t word = words_[rule].load(std::memory_order_acquire);
+        while (!IsLaterSession(word, generation) && Decode(word, generation) == from) {
+            if (words_[rule].compare_exchange_weak(word, Encode(to, generation), std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Only for a table that is not published yet.
+    void Store(std::uint32_t rule, FixRulePhase phase, std::uint32_t generation) {
+        words_[rule].store(Encode(phase, generation), std::memory_order_release);
+    }
+
+private:
+    static constexpr std::uint32_t kPhaseBits = 8;
+    static constexpr std::uint32_t kGenerationMask = 0xFFFFFFu;
+
+    static std::uint32_t Encode(FixRulePhase phase, std::uint32_t generation) {
+        return ((generation & kGenerationMask) << kPhaseBits) | static_cast<std::uint32_t>(phase);
+    }
+
+    // A word from a later session also reads as Idle to an older generation, but must not be overwritten by
+    // it. Generations are compared modulo 2^24, so the wrap of the session counter is harmless.
+    static bool IsLaterSession(std::uint32_t word, std::uint32_t generation) {
+        std::uint32_t ahead = ((word >> kPhaseBits) - generation) & kGenerationMask;
+        return ahead != 0 && ahead < (kGenerationMask + 1) / 2;
+    }
+
+    static FixRulePhase Decode(std::uint32_t word, std::uint32_t generation) {
+        if ((word >> kPhaseBits) != (generation & kGenerationMask)) {
+            return FixRulePhase::Idle;
+        }
+        return static_cast<FixRulePhase>(word & ((1u << kPhaseBits) - 1));
+    }
+
+    std::unique_ptr<std::atomic<std::uint32_t>[]> words_;
+};
+
+// ===== LOAD ORDER AND FORMID CACHE =====
+constexpr std::uint64_t kLoadOrderFingerprintSeed = 14695981039346656037ull;
+
+// FNV-1a step over one loaded plugin: its folded name and both compile slots.
+constexpr std::uint64_t HashLoadOrderEntry(std::uint64_t hash, std::string_view foldedName,
+                                           std::uint8_t compileIndex, std::uint16_t smallFileCompileIndex) {
+    for (char c : foldedName) {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+    }
+    hash = (hash ^ compileIndex) * 1099511628211ull;
+    hash = (hash ^ (smallFileCompileIndex & 0xFF)) * 1099511628211ull;
+    hash = (hash ^ (smallFileCompileIndex >> 8)) * 1099511628211ull;
+    return hash;
+}
+
+// Plugin names compare case-insensitively everywhere: the index, the cache keys and the fingerprint.
+inline std::string FoldPluginName(std::string_view name) {
+    std::string folded(name);
+    std::transform(folded.begin(), folded.end(), folded.begin(),
+                   [](unsigned char c) { return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c); });
+    return folded;
+}
+
+// Light plugins share the FE prefix and carry their slot in bits 12-23, leaving 12 bits of local ID.
+constexpr std::uint32_t EncodeFormID(std::uint8_t compileIndex, std::uint16_t smallFileCompileIndex,
+                                     std::uint32_t localID) {
+    if (compileIndex == 0xFE) {
+        return 0xFE000000 | (static_cast<std::uint32_t>(smallFileCompileIndex) << 12) | (localID & 0x00000FFF);
+    }
+    return (static_cast<std::uint32_t>(compileIndex) << 24) | (localID & 0x00FFFFFF);
+}
+
+// Parses a plugin-local FormID written as "625C7C", "XX625C7C" or "0x625C7C".
+inline bool ParseLocalFormID(std::string_view text, std::uint32_t& localID) {
+    if (text.size() >= 2 && (text.starts_with("XX") || text.starts_with("0x") || text.starts_with("0X"))) {
+        text.remove_prefix(2);
+    }
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), localID, 16);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size();
+}
+
+// Resolved quest and item FormIDs persisted between launches in "BWY-multi-Fix-NG.formcache", next to the
+// INI. The file is only trusted when its fingerprint matches the current load order; the plugin still checks
+// every cached ID against the live form table before use.
+constexpr std::uint32_t kFormIDCacheMagic = 0x43465742;  // "BWFC"
+constexpr std::uint32_t kFormIDCacheVersion = 1;
+
+struct FormIDCacheHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t fingerprint;
+    std::uint32_t entryCount;
+    std::uint32_t reserved;
+};
+
+enum class FormIDCacheLoad {
+    AlreadyLoaded,
+    Missing,
+    OtherLoadOrder,
+    Loaded
+};
+
+class FormIDCache {
+    std::filesystem::path path_;
+    std::uint64_t fingerprint_ = 0;
+    std::unordered_map<std::string, std::uint32_t> entries_;
+    bool loaded_ = false;
+    bool dirty_ = false;
+
+public:
+    static std::string QuestKey(std::string_view editorID) {
+        std::string key = "Q:";
+        key += editorID;
+        return key;
+    }
+
+    static std::string ItemKey(std::string_view plugin, std::string_view localID) {
+        std::string key = "I:";
+        key += plugin;
+        key += '|';
+        key += localID;
+        return FoldPluginName(key);
+    }
+
+    // Reads the cache once per process; a missing, damaged or foreign file leaves it empty, and a file
+    // written for another load order is overwritten by the next Save.
+    FormIDCacheLoad Load(const std::filesystem::path& path, std::uint64_t fingerprint) {
+        if (loaded_) {
+            return FormIDCacheLoad::AlreadyLoaded;
+        }
+        loaded_ = true;
+        path_ = path;
+        fingerprint_ = fingerprint;
+
+        std::ifstream file(path, std::ios::binary);
+        FormIDCacheHeader header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kFormIDCacheMagic ||
+            header.version != kFormIDCacheVersion) {
+            return FormIDCacheLoad::Missing;
+        }
+        if (header.fingerprint != fingerprint) {
+            dirty_ = true;
+            return FormIDCacheLoad::OtherLoadOrder;
+        }
+
+        for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+            std::uint32_t formID = 0;
+            std::uint16_t keyLength = 0;
+            if (!file.read(reinterpret_cast<char*>(&formID), sizeof(formID)) ||
+                !file.read(reinterpret_cast<char*>(&keyLength), sizeof(keyLength))) {
+                break;
+            }
+            std::string key(keyLength, '\0');
+            if (!file.read(key.data(), keyLength)) {
+                break;
+            }
+            entries_.emplace(std::move(key), formID);
+        }
+        return FormIDCacheLoad::Loaded;
+    }
+
+    std::uint32_t Find(const std::string& key) const {
+        auto it = entries_.find(key);
+        return it != entries_.end() ? it->second : 0;
+    }
+
+    void Store(std::string key, std::uint32_t formID) {
+        auto [it, inserted] = entries_.try_emplace(std::move(key), formID);
+        if (inserted || it->second != formID) {
+            it->second = formID;
+            dirty_ = true;
+        }
+    }
+
+    std::size_t Size() const { return entries_.size(); }
+
+    const std::filesystem::path& Path() const { return path_; }
+
+    // Writes the file only when something changed since Load; returns false if it could not be opened.
+    bool Save() {
+        if (!dirty_ || path_.empty()) {
+            return true;
+        }
+
+        std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        FormIDCacheHeader header{kFormIDCacheMagic, kFormIDCacheVersion, fingerprint_,
+                                 static_cast<std::uint32_t>(entries_.size()), 0};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& [key, formID] : entries_) {
+            auto keyLength = static_cast<std::uint16_t>((std::min)(key.size(), std::size_t{0xFFFF}));
+            file.write(reinterpret_cast<const char*>(&formID), sizeof(formID));
+            file.write(reinterpret_cast<const char*>(&keyLength), sizeof(keyLength));
+            file.write(key.data(), keyLength);
+        }
+        dirty_ = false;
+        return true;
+    }
+};
+
+// ===== TIMER WHEEL =====
+// Deferred actions for the monitor thread: a four-level hierarchical timing wheel with 10 ms ticks and 64
+// slots per level, reaching about 46 hours ahead. Timers are pooled nodes linked into their slot, so Schedule
+// and Cancel are O(1), and a level is cascaded into the ones below each time the level below wraps. Timers
+// further out than the wheel reaches wait in an overflow list that is re-linked each time the top level wraps,
+// so they fire at their own tick rather than at the horizon. Every
+// timer carries the session generation it was armed in; when it expires after another save was loaded it is
+// dropped instead of run. The wheel only moves when Advance is given a time, which keeps it clock-agnostic.
+constexpr std::uint32_t kTimerAnySession = 0;
+
+struct TimerHandle {
+    std::uint32_t node = 0xFFFFFFFF;
+    std::uint32_t serial = 0;
+};
+
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr auto kTick = std::chrono::milliseconds(10);
+
+private:
+    static constexpr std::uint32_t kLevels = 4;
+    static constexpr std::uint32_t kSlotBits = 6;
+    static constexpr std::uint32_t kSlots = 1u << kSlotBits;
+    static constexpr std::uint32_t kNil = 0xFFFFFFFF;
+    static constexpr std::uint64_t kHorizon = std::uint64_t{1} << (kSlotBits * kLevels);
+    static constexpr std::uint32_t kOverflow = kLevels;  // Node::level of timers beyond the horizon
+
+    struct Node {
+        std::uint64_t expiry = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t serial = 0;
+        std::uint32_t prev = kNil;
+        std::uint32_t next = kNil;
+        std::uint8_t level = 0;
+        std::uint8_t slot = 0;
+        bool armed = false;
+        std::function<void()> action;
+    };
+
+    std::mutex mutex_;
+    Clock::time_point origin_;
+    std::uint64_t current_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_;
+    std::array<std::array<std::uint32_t, kSlots>, kLevels> heads_ = MakeEmptyHeads();
+    std::uint32_t overflow_ = kNil;
+    std::array<std::size_t, kLevels + 1> levelCounts_{};  // the last entry counts the overflow list
+    std::size_t armedCount_ = 0;
+
+    static constexpr std::array<std::array<std::uint32_t, kSlots>, kLevels> MakeEmptyHeads() {
+        std::array<std::array<std::uint32_t, kSlots>, kLevels> heads{};
+        for (auto& level : heads) {
+            level.fill(kNil);
+        }
+        return heads;
+    }
+
+    // Deadlines round up so a timer never runs early; Advance rounds down.
+    std::uint64_t TickAt(Clock::time_point time, bool roundUp) const {
+        if (time <= origin_) {
+            return 0;
+        }
+        auto elapsed = time - origin_;
+        return static_cast<std::uint64_t>((roundUp ? elapsed + kTick - Clock::duration(1) : elapsed) / kTick);
+    }
+
+    Clock::time_point TimeAt(std::uint64_t tick) const { return origin_ + kTick * tick; }
+
+    std::uint32_t& HeadOf(const Node& node) {
+        return node.level == kOverflow ? overflow_ : heads_[node.level][node.slot];
+    }
+
+    void Link(std::uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.expiry < current_) {
+            node.expiry = current_;
+        }
+
+        std::uint64_t delta = node.expiry - current_;
+        std::uint32_t level = 0;
+        if (delta >= kHorizon) {
+            level = kOverflow;
+        } else {
+            while (level + 1 < kLevels && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) {
+                ++level;
+            }
+        }
+
+        node.level = static_cast<std::uint8_t>(level);
+        node.slot = 0;
+        if (level != kOverflow) {
+            node.slot = static_cast<std::uint8_t>((node.expiry >> (kSlotBits * level)) & (kSlots - 1));
+        }
+        std::uint32_t& head = HeadOf(node);
+        node.prev = kNil;
+        node.next = head;
+        if (head != kNil) {
+            nodes_[head].prev = index;
+        }
+        head = index;
+        ++levelCounts_[level];
+    }
+
+    void Unlink(std::uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != kNil) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            HeadOf(node) = node.next;
+        }
+        if (node.next != kNil) {
+            nodes_[node.next].prev = node.prev;
+        }
+        --levelCounts_[node.level];
+    }
+
+    void Release(std::uint32_t index) {
+        Node& node = nodes_[index];
+        node.armed = false;
+        node.action = nullptr;
+        ++node.serial;
+        free_.push_back(index);
+        --armedCount_;
+    }
+
+    void Cascade(std::uint32_t level) {
+        std::uint32_t& head =
+            level == kOverflow ? overflow_ : heads_[level][(current_ >> (kSlotBits * level)) & (kSlots - 1)];
+        std::uint32_t index = head;
+        head = kNil;
+        while (index != kNil) {
+            std::uint32_t next = nodes_[index].next;
+            --levelCounts_[level];
+            Link(index);
+            index = next;
+        }
+    }
+
+public:
+    // Ticks are counted from origin; tests pass a fake clock's start time.
+    explicit TimerWheel(Clock::time_point origin = Clock::now()) : origin_(origin) {}
+
+    TimerHandle ScheduleAt(Clock::time_point when, std::uint32_t generation, std::function<void()> action) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+
+        Node& node = nodes_[index];
+        node.expiry = (std::max)(TickAt(when, true), current_ + 1);
+        node.generation = generation;
+        node.armed = true;
+        node.action = std::move(action);
+        Link(index);
+        ++armedCount_;
+        return {index, node.serial};
+    }
+
+    TimerHandle Schedule(Clock::duration delay, std::uint32_t generation, std::function<void()> action) {
+        return ScheduleAt(Clock::now() + delay, generation, std::move(action));
+    }
+
+    bool Cancel(TimerHandle handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (handle.node >= nodes_.size() || !nodes_[handle.node].armed || nodes_[handle.node].serial != handle.serial) {
+            return false;
+        }
+        Unlink(handle.node);
+        Release(handle.node);
+        return true;
+    }
+
+    // Moves the wheel up to now and runs every due action whose generation is kTimerAnySession or
+    // currentGeneration, outside the wheel's lock. Returns how many stale timers were dropped.
+    std::size_t Advance(Clock::time_point now, std::uint32_t currentGeneration) {
+        std::vector<std::function<void()>> due;
+        std::size_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const std::uint64_t target = TickAt(now, false);
+
+            while (current_ < target) {
+                if (armedCount_ == 0) {
+                    current_ = target;
+                    break;
+                }
+
+                // Nothing can expire before the next boundary of the lowest occupied level, so jump there.
+                std::uint32_t lowest = 0;
+                while (lowest + 1 < kLevels && levelCounts_[lowest] == 0) {
+                    ++lowest;
+                }
+                std::uint64_t span = lowest == 0 ? 1 : std::uint64_t{1} << (kSlotBits * lowest);
+                current_ = (std::min)(target, (current_ / span + 1) * span);
+
+                // Overflow timers still out of reach are linked straight back into the overflow list.
+                for (std::uint32_t level = kOverflow; level >= 1; --level) {
+                    if ((current_ & ((std::uint64_t{1} << (kSlotBits * level)) - 1)) == 0) {
+                        Cascade(level);
+                    }
+                }
+
+                std::uint32_t& head = heads_[0][current_ & (kSlots - 1)];
+                std::uint32_t index = head;
+                head = kNil;
+                while (index != kNil) {
+                    Node& node = nodes_[index];
+                    std::uint32_t next = node.next;
+                    --levelCounts_[0];
+                    if (node.generation == kTimerAnySession || node.generation == currentGeneration) {
+                        due.push_back(std::move(node.action));
+                    } else {
+                        ++dropped;
+                    }
+                    Release(index);
+                    index = next;
+                }
+            }
+        }
+
+        for (auto& action : due) {
+            action();
+        }
+        return dropped;
+    }
+
+    // The earliest expiry of any armed timer, so the caller wakes once per due timer rather than at every
+    // cascade boundary. Within a level, slots taken in order from the current position cover successive time
+    // ranges, so only the first occupied slot of each level needs its list walked.
+    std::optional<Clock::time_point> NextDeadline() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (armedCount_ == 0) {
+            return std::nullopt;
+        }
+
+        std::uint64_t earliest = ~std::uint64_t{0};
+        for (std::uint32_t level = 0; level < kLevels; ++level) {
+            if (levelCounts_[level] == 0) {
+                continue;
+            }
+            const std::uint64_t position = current_ >> (kSlotBits * level);
+            for (std::uint64_t offset = 1; offset <= kSlots; ++offset) {
+                std::uint32_t index = heads_[level][(position + offset) & (kSlots - 1)];
+                if (index == kNil) {
+                    continue;
+                }
+                for (; index != kNil; index = nodes_[index].next) {
+                    earliest = (std::min)(earliest, nodes_[index].expiry);
+                }
+                break;
+            }
+        }
+        for (std::uint32_t index = overflow_; index != kNil; index = nodes_[index].next) {
+            earliest = (std::min)(earliest, nodes_[index].expiry);
+        }
+        return TimeAt(earliest);
+    }
+};
+
+// ===== MONITOR SCHEDULE =====
+// When the monitor thread next has to run without being woken: the next poll while a rule's quest is running,
+// or the next timer, whichever comes first. Idle and finished rules are left to the quest and container
+// events, so with neither the monitor has no deadline and sleeps until it is woken.
+inline std::optional<std::chrono::steady_clock::time_point> NextMonitorDeadline(
+    const FixRulePhaseWords& phases, std::uint32_t ruleCount, std::uint32_t session,
+    std::chrono::steady_clock::time_point lastPoll, std::chrono::milliseconds interval,
+    std::optional<std::chrono::steady_clock::time_point> timerDeadline) {
+    for (std::uint32_t rule = 0; rule < ruleCount; ++rule) {
+        FixRulePhase phase = phases.Load(rule, session);
+        if (phase == FixRulePhase::Active || phase == FixRulePhase::Triggered) {
+            auto poll = lastPoll + interval;
+            return timerDeadline && *timerDeadline < poll ? *timerDeadline : poll;
+        }
+    }
+    return timerDeadline;
+}
+
+// ===== GAME COMMAND RING =====
+// Engine work decided off the game thread, queued for the plugin's once-per-frame drain task.
+enum class GameCommandKind : std::uint8_t {
+    SetStage,
+    ConsoleCommand,
+    RemoveItem,
+    Notification,
+    MessageBox,
+    ReconcileInventory
+};
+
+// SetStage uses formID for the quest, count for the stage and text for the quest's editor ID.
+struct GameCommand {
+    GameCommandKind kind = GameCommandKind::Notification;
+    std::uint32_t formID = 0;
+    std::int32_t count = 0;
+    std::string text;
+    std::uint32_t generation = kTimerAnySession;
+    std::function<void(bool)> onComplete;
+    std::chrono::steady_clock::time_point issuedAt{};
+};
+
+// The console route for a SetStage the native call refused: one "setstage <editor ID> <stage>" line that keeps
+// the command's session, callback and issue time.
+inline GameCommand MakeConsoleStageCommand(GameCommand command) {
+    std::string line = "setstage ";
+    line += command.text;
+    line += ' ';
+    line += std::to_string(command.count);
+    command.kind = GameCommandKind::ConsoleCommand;
+    command.text = std::move(line);
+    return command;
+}
+
+constexpr std::size_t kGameCommandCapacity = 256;
+constexpr auto kGameCommandFrameBudget = std::chrono::microseconds(1000);
+
+// Bounded MPSC ring with the slot protocol of LogRingBuffer. Slots own their command, so strings and
+// callbacks move through it instead of being copied into fixed buffers.
+class GameCommandRing {
+public:
+    GameCommandRing() {
+        for (std::size_t i = 0; i < kGameCommandCapacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPush(GameCommand&& command) {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        for (;;) {
+            slot = &slots_[pos & kMask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->command = std::move(command);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only.
+    GameCommand* Front() {
+        Slot& slot = slots_[dequeuePos_ & kMask];
+        return slot.sequence.load(std::memory_order_acquire) == dequeuePos_ + 1 ? &slot.command : nullptr;
+    }
+
+    void Pop() {
+        Slot& slot = slots_[dequeuePos_ & kMask];
+        slot.command = {};
+        slot.sequence.store(dequeuePos_ + kGameCommandCapacity, std::memory_order_release);
+        ++dequeuePos_;
+    }
+
+    // Consumer side: runs queued commands until the ring is empty or the budget is spent, measured with
+    // Clock so a simulated frame loop can drive it. The first command always runs, so one slow command
+    // cannot stall the queue. Consecutive removals of the same item run as one RemoveItem call, and
+    // consecutive console commands are compiled as one script. Commands queued for a session other than
+    // session (a save loaded since they were submitted) are never executed and complete as failed. Every
+    // callback is handed to complete(onComplete, generation, succeeded); an executor that finishes a command
+    // later takes its onComplete and reports through complete itself.
+    template <class Clock, class Execute, class OnComplete>
+    std::size_t RunFrame(typename Clock::duration budget, std::uint32_t session, Execute&& execute,
+                         OnComplete&& complete) {
+        const auto start = Clock::now();
+        std::size_t executed = 0;
+        auto isStale = [session](const GameCommand& command) {
+            return command.generation != kTimerAnySession && command.generation != session;
+        };
+
+        while (GameCommand* front = Front()) {
+            if (isStale(*front)) {
+                complete(std::move(front->onComplete), front->generation, false);
+                Pop();
+                continue;
+            }
+            if (executed > 0 && Clock::now() - start >= budget) {
+                break;
+            }
+
+            GameCommand command = std::move(*front);
+            Pop();
+            callbacks_.clear();
+            ++executed;
+
+            while (GameCommand* next = Front()) {
+                if (next->kind != command.kind || isStale(*next)) {
+                    break;
+                }
+                if (command.kind == GameCommandKind::RemoveItem && next->formID == command.formID) {
+                    command.count += next->count;
+                } else if (command.kind == GameCommandKind::ConsoleCommand) {
+                    command.text += '\n';
+                    command.text += next->text;
+                } else {
+                    break;
+                }
+                callbacks_.emplace_back(std::move(next->onComplete), next->generation);
+                Pop();
+                ++executed;
+            }
+
+            bool succeeded = execute(command);
+            callbacks_.emplace_back(std::move(command.onComplete), command.generation);
+            for (auto& [onComplete, generation] : callbacks_) {
+                complete(std::move(onComplete), generation, succeeded);
+            }
+        }
+        return executed;
+    }
+
+private:
+    static_assert((kGameCommandCapacity & (kGameCommandCapacity - 1)) == 0, "Ring capacity must be a power of two");
+    static constexpr std::size_t kMask = kGameCommandCapacity - 1;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        GameCommand command;
+    };
+
+    Slot slots_[kGameCommandCapacity];
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::size_t dequeuePos_ = 0;
+    std::vector<std::pair<std::function<void(bool)>, std::uint32_t>> callbacks_;  // consumer only
+};
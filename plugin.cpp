@@ -1,1683 +1,2549 @@
-﻿#include <RE/Skyrim.h>
-#include <SKSE/SKSE.h>
-#include <shlobj.h>
-#include <spdlog/sinks/basic_file_sink.h>
-#include <windows.h>
-
-#include <algorithm>
-#include <atomic>
-#include <chrono>
-#include <ctime>
-#include <deque>
-#include <filesystem>
-#include <fstream>
-#include <iomanip>
-#include <map>
-#include <mutex>
-#include <sstream>
-#include <string>
-#include <thread>
-#include <unordered_set>
-#include <vector>
-
-namespace fs = std::filesystem;
-namespace logger = SKSE::log;
-
-struct SKSELogsPaths {
-    fs::path primary;
-    fs::path secondary;
-};
-
-struct PluginConfig {
-    struct {
-        bool enabled = true;
-        std::string questEditorID = "YW_Quest_MDF";
-        std::string questPlugin = "YurianaWench.esp";
-        int triggerStage = 21;
-        int completionStage = 30;
-        bool showNotification = true;
-    } quest;
-
-    struct {
-        bool enabled = true;
-        std::string itemID = "625C7C";
-        std::string itemPlugin = "YurianaWench.esp";
-        std::string itemName = "Lelyna's Remedy";
-        bool removeOnDetection = true;
-        bool showNotification = true;
-    } item;
-
-    struct {
-        bool enabled = true;
-        std::string triggerMessage = "You must craft Lelyna's Remedy to cure Elora. Check your inventory for the recipe.";
-        std::string completionMessage = "You have crafted the potion and the temple girls are very happy. You have saved Elora!";
-        bool showTriggerMessage = true;
-        bool showCompletionMessage = true;
-    } messages;
-
-    struct {
-        bool enabled = true;
-        int checkIntervalMs = 1000;
-        float maxDetectionDistance = 5000.0f;
-    } monitoring;
-
-    struct {
-        bool enabled = true;
-    } notification;
-};
-
-struct CachedFormIDs {
-    RE::FormID questFormID = 0;
-    RE::FormID itemFormID = 0;
-    bool questResolved = false;
-    bool itemResolved = false;
-};
-
-struct QuestStateData {
-    bool questActive = false;
-    bool triggerStageReached = false;
-    bool itemDetected = false;
-    bool completionDone = false;
-    int currentStage = 0;
-    std::chrono::steady_clock::time_point lastCheck;
-};
-
-static std::deque<std::string> g_actionLines;
-static std::deque<std::string> g_questLines;
-static std::deque<std::string> g_systemLines;
-static std::string g_documentsPath;
-static std::string g_gamePath;
-static bool g_isInitialized = false;
-static std::mutex g_logMutex;
-static std::mutex g_questMutex;
-static std::mutex g_configMutex;
-static std::mutex g_cacheMutex;
-static bool g_monitoringActive = false;
-static std::thread g_monitorThread;
-static int g_monitorCycles = 0;
-static std::chrono::steady_clock::time_point g_monitoringStartTime;
-static bool g_initialDelayComplete = false;
-static std::atomic<bool> g_isShuttingDown(false);
-static std::atomic<bool> g_isInGameTransition(false);
-static SKSELogsPaths g_logPaths;
-static PluginConfig g_config;
-static CachedFormIDs g_cachedFormIDs;
-static QuestStateData g_questState;
-
-static std::atomic<bool> g_questMonitoringActive(false);
-static std::chrono::steady_clock::time_point g_lastQuestCheck;
-static std::chrono::steady_clock::time_point g_lastItemCheck;
-
-static bool g_triggerMessageShown = false;
-static bool g_completionMessageShown = false;
-static bool g_potionDetectedMessageShown = false;
-static std::chrono::steady_clock::time_point g_potionDetectedTime;
-static bool g_waitingForPotionDelay = false;
-
-void StartMonitoringThread();
-void StopMonitoringThread();
-void WriteToActionsLog(const std::string& message, int lineNumber = 0);
-void WriteToQuestLog(const std::string& message, int lineNumber = 0);
-void WriteToSystemLog(const std::string& message, int lineNumber = 0);
-void CheckQuestState();
-void CheckPlayerInventory();
-void ProcessQuestTrigger();
-void ProcessItemDetection();
-void ProcessQuestCompletion();
-void ResolveFormIDs();
-void ValidatePluginsInINI();
-bool LoadConfiguration();
-void SaveDefaultConfiguration();
-fs::path GetPluginINIPath();
-RE::FormID GetFormIDFromPlugin(const std::string& pluginName, const std::string& localFormID);
-RE::TESQuest* GetQuestByEditorID(const std::string& editorID);
-int GetQuestCurrentStage(RE::TESQuest* quest);
-bool SetQuestStage(RE::TESQuest* quest, int stage);
-bool PlayerHasItem(RE::FormID itemFormID);
-bool RemoveItemFromPlayer(RE::FormID itemFormID, int count = 1);
-void ShowNotificationMessage(const std::string& message);
-void ShowMessageBox(const std::string& message);
-
-std::string SafeWideStringToString(const std::wstring& wstr) {
-    if (wstr.empty()) return std::string();
-    try {
-        int size_needed = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), (int)wstr.size(), NULL, 0, NULL, NULL);
-        if (size_needed <= 0) {
-            size_needed = WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), (int)wstr.size(), NULL, 0, NULL, NULL);
-            if (size_needed <= 0) return std::string();
-            std::string result(size_needed, 0);
-            int converted = WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), (int)wstr.size(), &result[0], size_needed, NULL, NULL);
-            if (converted <= 0) return std::string();
-            return result;
-        }
-        std::string result(size_needed, 0);
-        int converted = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), (int)wstr.size(), &result[0], size_needed, NULL, NULL);
-        if (converted <= 0) return std::string();
-        return result;
-    } catch (...) {
-        std::string result;
-        result.reserve(wstr.size());
-        for (wchar_t wc : wstr) {
-            if (wc <= 127) {
-                result.push_back(static_cast<char>(wc));
-            } else {
-                result.push_back('?');
-            }
-        }
-        return result;
-    }
-}
-
-std::string GetEnvVar(const std::string& key) {
-    char* buf = nullptr;
-    size_t sz = 0;
-    if (_dupenv_s(&buf, &sz, key.c_str()) == 0 && buf != nullptr) {
-        std::string value(buf);
-        free(buf);
-        return value;
-    }
-    return "";
-}
-
-std::string NormalizeName(const std::string& name) {
-    std::string normalized = name;
-    normalized.erase(0, normalized.find_first_not_of(" \t\r\n"));
-    normalized.erase(normalized.find_last_not_of(" \t\r\n") + 1);
-    return normalized;
-}
-
-std::string GetCurrentTimeString() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm buf;
-    localtime_s(&buf, &time_t);
-    std::stringstream ss;
-    ss << std::put_time(&buf, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
-
-std::string GetCurrentTimeStringWithMillis() {
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm buf;
-    localtime_s(&buf, &time_t);
-    std::stringstream ss;
-    ss << std::put_time(&buf, "%Y-%m-%d %H:%M:%S");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    return ss.str();
-}
-
-void WriteToDualPath(const fs::path& primaryPath, const fs::path& secondaryPath,
-                     const std::string& content, std::ios::openmode mode) {
-    try {
-        if (!primaryPath.parent_path().empty() && !fs::exists(primaryPath.parent_path())) {
-            fs::create_directories(primaryPath.parent_path());
-        }
-        std::ofstream primaryFile(primaryPath, mode);
-        if (primaryFile.is_open()) {
-            primaryFile << content << std::endl;
-            primaryFile.close();
-        }
-    } catch (...) {}
-
-    try {
-        if (!secondaryPath.parent_path().empty() && !fs::exists(secondaryPath.parent_path())) {
-            fs::create_directories(secondaryPath.parent_path());
-        }
-        std::ofstream secondaryFile(secondaryPath, mode);
-        if (secondaryFile.is_open()) {
-            secondaryFile << content << std::endl;
-            secondaryFile.close();
-        }
-    } catch (...) {}
-}
-
-// ===== LOG SYSTEM - ACTIONS LOG =====
-void WriteToActionsLog(const std::string& message, int lineNumber) {
-    std::lock_guard<std::mutex> lock(g_logMutex);
-
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm buf;
-    localtime_s(&buf, &time_t);
-
-    std::stringstream ss;
-    ss << "[" << std::put_time(&buf, "%Y-%m-%d %H:%M:%S");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count() << "] ";
-    ss << "[log] [info] ";
-    ss << "[plugin.cpp:" << lineNumber << "] ";
-    ss << message;
-
-    std::string newLine = ss.str();
-    g_actionLines.push_back(newLine);
-
-    if (g_actionLines.size() > 2000) {
-        g_actionLines.pop_front();
-    }
-
-    static size_t lineCount = 0;
-    lineCount++;
-
-    fs::path primaryLogPath = g_logPaths.primary / "BWY-multi-Fix-NG-Actions.log";
-    fs::path secondaryLogPath = g_logPaths.secondary / "BWY-multi-Fix-NG-Actions.log";
-
-    if (lineCount >= 2500) {
-        std::stringstream bulkContent;
-        for (const auto& line : g_actionLines) {
-            bulkContent << line << "\n";
-        }
-        WriteToDualPath(primaryLogPath, secondaryLogPath, bulkContent.str(), std::ios::trunc);
-        lineCount = g_actionLines.size();
-    } else {
-        WriteToDualPath(primaryLogPath, secondaryLogPath, newLine, std::ios::app);
-    }
-}
-
-// ===== LOG SYSTEM - QUEST LOG =====
-void WriteToQuestLog(const std::string& message, int lineNumber) {
-    std::lock_guard<std::mutex> lock(g_logMutex);
-
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm buf;
-    localtime_s(&buf, &time_t);
-
-    std::stringstream ss;
-    ss << "[" << std::put_time(&buf, "%Y-%m-%d %H:%M:%S");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count() << "] ";
-    ss << "[quest] [info] ";
-    ss << "[plugin.cpp:" << lineNumber << "] ";
-    ss << message;
-
-    std::string newLine = ss.str();
-    g_questLines.push_back(newLine);
-
-    if (g_questLines.size() > 2000) {
-        g_questLines.pop_front();
-    }
-
-    static size_t lineCount = 0;
-    lineCount++;
-
-    fs::path primaryLogPath = g_logPaths.primary / "BWY-multi-Fix-NG-Quest.log";
-    fs::path secondaryLogPath = g_logPaths.secondary / "BWY-multi-Fix-NG-Quest.log";
-
-    if (lineCount >= 2500) {
-        std::stringstream bulkContent;
-        for (const auto& line : g_questLines) {
-            bulkContent << line << "\n";
-        }
-        WriteToDualPath(primaryLogPath, secondaryLogPath, bulkContent.str(), std::ios::trunc);
-        lineCount = g_questLines.size();
-    } else {
-        WriteToDualPath(primaryLogPath, secondaryLogPath, newLine, std::ios::app);
-    }
-}
-
-// ===== LOG SYSTEM - SYSTEM LOG =====
-void WriteToSystemLog(const std::string& message, int lineNumber) {
-    std::lock_guard<std::mutex> lock(g_logMutex);
-
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm buf;
-    localtime_s(&buf, &time_t);
-
-    std::stringstream ss;
-    ss << "[" << std::put_time(&buf, "%Y-%m-%d %H:%M:%S");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count() << "] ";
-    ss << "[system] [info] ";
-    ss << "[plugin.cpp:" << lineNumber << "] ";
-    ss << message;
-
-    std::string newLine = ss.str();
-    g_systemLines.push_back(newLine);
-
-    if (g_systemLines.size() > 2000) {
-        g_systemLines.pop_front();
-    }
-
-    static size_t lineCount = 0;
-    lineCount++;
-
-    fs::path primaryLogPath = g_logPaths.primary / "BWY-multi-Fix-NG-System.log";
-    fs::path secondaryLogPath = g_logPaths.secondary / "BWY-multi-Fix-NG-System.log";
-
-    if (lineCount >= 2500) {
-        std::stringstream bulkContent;
-        for (const auto& line : g_systemLines) {
-            bulkContent << line << "\n";
-        }
-        WriteToDualPath(primaryLogPath, secondaryLogPath, bulkContent.str(), std::ios::trunc);
-        lineCount = g_systemLines.size();
-    } else {
-        WriteToDualPath(primaryLogPath, secondaryLogPath, newLine, std::ios::app);
-    }
-}
-
-fs::path GetPluginINIPath() {
-    wchar_t exePath[MAX_PATH];
-    GetModuleFileNameW(NULL, exePath, MAX_PATH);
-    fs::path gamePath = fs::path(exePath).parent_path();
-    fs::path pluginConfigDir = gamePath / "Data" / "SKSE" / "Plugins";
-    
-    if (!fs::exists(pluginConfigDir)) {
-        fs::create_directories(pluginConfigDir);
-    }
-    
-    return pluginConfigDir / "BWY-multi-Fix-NG.ini";
-}
-
-bool IsDLCInstalled(const std::string& dlcName) {
-    auto* dataHandler = RE::TESDataHandler::GetSingleton();
-    if (!dataHandler) return false;
-    
-    auto* file = dataHandler->LookupModByName(dlcName);
-    return (file != nullptr);
-}
-
-bool IsPluginLoaded(const std::string& pluginName) {
-    auto* dataHandler = RE::TESDataHandler::GetSingleton();
-    if (!dataHandler) return false;
-    
-    auto* file = dataHandler->LookupModByName(pluginName);
-    return (file != nullptr);
-}
-
-RE::FormID GetFormIDFromPlugin(const std::string& pluginName, const std::string& localFormID) {
-    auto* dataHandler = RE::TESDataHandler::GetSingleton();
-    if (!dataHandler) {
-        logger::error("Failed to get TESDataHandler");
-        return 0;
-    }
-
-    auto* file = dataHandler->LookupModByName(pluginName);
-    if (!file) {
-        logger::error("Plugin not found: {}", pluginName);
-        return 0;
-    }
-
-    std::string cleanID = localFormID;
-    if (cleanID.length() >= 2 && cleanID.substr(0, 2) == "XX") {
-        cleanID = cleanID.substr(2);
-    }
-
-    RE::FormID localID = 0;
-    try {
-        localID = std::stoul(cleanID, nullptr, 16);
-    } catch (...) {
-        logger::error("Failed to parse FormID: {}", cleanID);
-        return 0;
-    }
-
-    uint8_t modIndex = file->compileIndex;
-    if (modIndex == 0xFF) {
-        modIndex = file->smallFileCompileIndex;
-    }
-
-    RE::FormID fullFormID = (static_cast<RE::FormID>(modIndex) << 24) | (localID & 0x00FFFFFF);
-    
-    return fullFormID;
-}
-
-RE::TESQuest* GetQuestByEditorID(const std::string& editorID) {
-    auto* quest = RE::TESForm::LookupByEditorID<RE::TESQuest>(editorID);
-    return quest;
-}
-
-int GetQuestCurrentStage(RE::TESQuest* quest) {
-    if (!quest) return -1;
-    return quest->GetCurrentStageID();
-}
-
-void ExecuteConsoleCommand(const std::string& command) {
-    try {
-        auto* scriptFactory = RE::IFormFactory::GetConcreteFormFactoryByType<RE::Script>();
-        if (!scriptFactory) {
-            WriteToActionsLog("ERROR: Failed to get Script factory", __LINE__);
-            return;
-        }
-        
-        auto* script = scriptFactory->Create();
-        if (!script) {
-            WriteToActionsLog("ERROR: Failed to create Script object", __LINE__);
-            return;
-        }
-        
-        script->SetCommand(command);
-        script->CompileAndRun(nullptr);
-        delete script;
-        
-        WriteToActionsLog("Console command executed: " + command, __LINE__);
-    } catch (...) {
-        WriteToActionsLog("ERROR: Exception executing console command: " + command, __LINE__);
-    }
-}
-
-bool SetQuestStageViaConsole(const std::string& questEditorID, int stage) {
-    std::string command = "setstage " + questEditorID + " " + std::to_string(stage);
-    
-    WriteToQuestLog("========================================", __LINE__);
-    WriteToQuestLog("EXECUTING CONSOLE COMMAND", __LINE__);
-    WriteToQuestLog("Command: " + command, __LINE__);
-    WriteToQuestLog("========================================", __LINE__);
-    
-    ExecuteConsoleCommand(command);
-    
-    return true;
-}
-
-bool PlayerHasItem(RE::FormID itemFormID) {
-    if (itemFormID == 0) return false;
-
-    auto* player = RE::PlayerCharacter::GetSingleton();
-    if (!player) return false;
-
-    auto* itemForm = RE::TESForm::LookupByID(itemFormID);
-    if (!itemForm) return false;
-
-    auto* boundObject = itemForm->As<RE::TESBoundObject>();
-    if (!boundObject) return false;
-
-    auto inventory = player->GetInventory();
-    auto it = inventory.find(boundObject);
-    if (it != inventory.end()) {
-        if (it->second.first > 0) {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-bool RemoveItemFromPlayer(RE::FormID itemFormID, int count) {
-    if (itemFormID == 0) return false;
-    
-    auto* player = RE::PlayerCharacter::GetSingleton();
-    if (!player) return false;
-    
-    auto* itemForm = RE::TESForm::LookupByID(itemFormID);
-    if (!itemForm) return false;
-    
-    auto* boundObject = itemForm->As<RE::TESBoundObject>();
-    if (!boundObject) return false;
-    
-    try {
-        player->RemoveItem(boundObject, count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
-        WriteToActionsLog("Removed " + std::to_string(count) + " item(s) from player inventory", __LINE__);
-        return true;
-    } catch (...) {
-        WriteToActionsLog("Exception while removing item from player inventory", __LINE__);
-        return false;
-    }
-}
-
-void ShowNotificationMessage(const std::string& message) {
-    if (message.empty()) return;
-    RE::DebugNotification(message.c_str());
-}
-
-void ShowMessageBox(const std::string& message) {
-    if (message.empty()) return;
-    
-    auto* messageQueue = RE::UIMessageQueue::GetSingleton();
-    if (!messageQueue) {
-        ShowNotificationMessage(message);
-        return;
-    }
-    
-    RE::DebugMessageBox(message.c_str());
-}
-
-std::string GetDocumentsPath() {
-    try {
-        wchar_t path[MAX_PATH] = {0};
-        HRESULT result = SHGetFolderPathW(NULL, CSIDL_PERSONAL, NULL, SHGFP_TYPE_CURRENT, path);
-        if (SUCCEEDED(result)) {
-            std::wstring ws(path);
-            std::string converted = SafeWideStringToString(ws);
-            if (!converted.empty()) {
-                return converted;
-            }
-        }
-        std::string userProfile = GetEnvVar("USERPROFILE");
-        if (!userProfile.empty()) {
-            return userProfile + "\\Documents";
-        }
-        return "C:\\Users\\Default\\Documents";
-    } catch (...) {
-        return "C:\\Users\\Default\\Documents";
-    }
-}
-
-bool IsValidPluginPath(const fs::path& pluginPath) {
-    const std::vector<std::string> dllNames = {
-        "BWY-multi-Fix-NG.dll"
-    };
-    
-    for (const auto& dllName : dllNames) {
-        fs::path dllPath = pluginPath / dllName;
-        try {
-            if (fs::exists(dllPath)) {
-                return true;
-            }
-        } catch (...) {
-            continue;
-        }
-    }
-    return false;
-}
-
-fs::path BuildPathCaseInsensitive(const fs::path& basePath, const std::vector<std::string>& components) {
-    try {
-        fs::path currentPath = basePath;
-        
-        for (const auto& component : components) {
-            fs::path testPath = currentPath / component;
-            if (fs::exists(testPath)) {
-                currentPath = testPath;
-                continue;
-            }
-            
-            std::string lowerComponent = component;
-            std::transform(lowerComponent.begin(), lowerComponent.end(), 
-                         lowerComponent.begin(), ::tolower);
-            testPath = currentPath / lowerComponent;
-            if (fs::exists(testPath)) {
-                currentPath = testPath;
-                continue;
-            }
-            
-            std::string upperComponent = component;
-            std::transform(upperComponent.begin(), upperComponent.end(), 
-                         upperComponent.begin(), ::toupper);
-            testPath = currentPath / upperComponent;
-            if (fs::exists(testPath)) {
-                currentPath = testPath;
-                continue;
-            }
-            
-            bool found = false;
-            if (fs::exists(currentPath) && fs::is_directory(currentPath)) {
-                for (const auto& entry : fs::directory_iterator(currentPath)) {
-                    try {
-                        std::string entryName = entry.path().filename().string();
-                        std::string lowerEntryName = entryName;
-                        std::transform(lowerEntryName.begin(), lowerEntryName.end(), 
-                                     lowerEntryName.begin(), ::tolower);
-                        
-                        if (lowerEntryName == lowerComponent) {
-                            currentPath = entry.path();
-                            found = true;
-                            break;
-                        }
-                    } catch (...) {
-                        continue;
-                    }
-                }
-            }
-            
-            if (!found) {
-                currentPath = currentPath / component;
-            }
-        }
-        
-        return currentPath;
-        
-    } catch (...) {
-        return basePath;
-    }
-}
-
-fs::path GetDllDirectory() {
-    try {
-        HMODULE hModule = nullptr;
-        static int dummyVariable = 0;
-
-        if (GetModuleHandleExA(
-            GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | 
-            GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
-            reinterpret_cast<LPCSTR>(&dummyVariable), 
-            &hModule) && hModule != nullptr) {
-            
-            wchar_t dllPath[MAX_PATH] = {0};
-            DWORD size = GetModuleFileNameW(hModule, dllPath, MAX_PATH);
-
-            if (size > 0) {
-                std::wstring wsDllPath(dllPath);
-                std::string dllPathStr = SafeWideStringToString(wsDllPath);
-
-                if (!dllPathStr.empty()) {
-                    fs::path dllDir = fs::path(dllPathStr).parent_path();
-                    return dllDir;
-                }
-            }
-        }
-
-        return fs::path();
-
-    } catch (...) {
-        return fs::path();
-    }
-}
-
-std::string GetGamePath() {
-    try {
-        std::string mo2Path = GetEnvVar("MO2_MODS_PATH");
-        if (!mo2Path.empty()) {
-            fs::path testPath = BuildPathCaseInsensitive(
-                fs::path(mo2Path), {"Data", "SKSE", "Plugins"}
-            );
-            if (IsValidPluginPath(testPath)) {
-                WriteToSystemLog("Game path detected: MO2 Environment Variable", __LINE__);
-                return mo2Path;
-            }
-        }
-
-        std::string mo2Overwrite = GetEnvVar("MO_OVERWRITE_PATH");
-        if (!mo2Overwrite.empty()) {
-            fs::path testPath = BuildPathCaseInsensitive(
-                fs::path(mo2Overwrite), {"SKSE", "Plugins"}
-            );
-            if (IsValidPluginPath(testPath)) {
-                WriteToSystemLog("Game path detected: MO2 Overwrite Path", __LINE__);
-                return mo2Overwrite;
-            }
-        }
-
-        std::string vortexPath = GetEnvVar("VORTEX_MODS_PATH");
-        if (!vortexPath.empty()) {
-            fs::path testPath = BuildPathCaseInsensitive(
-                fs::path(vortexPath), {"Data", "SKSE", "Plugins"}
-            );
-            if (IsValidPluginPath(testPath)) {
-                WriteToSystemLog("Game path detected: Vortex Environment Variable", __LINE__);
-                return vortexPath;
-            }
-        }
-
-        std::string skyrimMods = GetEnvVar("SKYRIM_MODS_FOLDER");
-        if (!skyrimMods.empty()) {
-            fs::path testPath = BuildPathCaseInsensitive(
-                fs::path(skyrimMods), {"Data", "SKSE", "Plugins"}
-            );
-            if (IsValidPluginPath(testPath)) {
-                WriteToSystemLog("Game path detected: SKYRIM_MODS_FOLDER Variable", __LINE__);
-                return skyrimMods;
-            }
-        }
-
-        std::vector<std::string> registryKeys = {
-            "SOFTWARE\\WOW6432Node\\Bethesda Softworks\\Skyrim Special Edition",
-            "SOFTWARE\\Bethesda Softworks\\Skyrim Special Edition",
-            "SOFTWARE\\WOW6432Node\\GOG.com\\Games\\1457087920",
-            "SOFTWARE\\GOG.com\\Games\\1457087920",
-            "SOFTWARE\\WOW6432Node\\Valve\\Steam\\Apps\\489830",
-            "SOFTWARE\\WOW6432Node\\Valve\\Steam\\Apps\\611670"
-        };
-
-        HKEY hKey;
-        char pathBuffer[MAX_PATH] = {0};
-        DWORD pathSize = sizeof(pathBuffer);
-
-        for (const auto& key : registryKeys) {
-            if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, key.c_str(), 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
-                if (RegQueryValueExA(hKey, "Installed Path", NULL, NULL, (LPBYTE)pathBuffer, &pathSize) == ERROR_SUCCESS) {
-                    RegCloseKey(hKey);
-                    std::string result(pathBuffer);
-                    if (!result.empty()) {
-                        fs::path testPath = BuildPathCaseInsensitive(
-                            fs::path(result), {"Data", "SKSE", "Plugins"}
-                        );
-                        if (IsValidPluginPath(testPath)) {
-                            WriteToSystemLog("Game path detected: Windows Registry", __LINE__);
-                            return result;
-                        }
-                    }
-                }
-                RegCloseKey(hKey);
-            }
-            pathSize = sizeof(pathBuffer);
-        }
-
-        std::vector<std::string> commonPaths = {
-            "C:\\Program Files (x86)\\Steam\\steamapps\\common\\Skyrim Special Edition",
-            "C:\\Program Files\\Steam\\steamapps\\common\\Skyrim Special Edition",
-            "D:\\Steam\\steamapps\\common\\Skyrim Special Edition",
-            "D:\\SteamLibrary\\steamapps\\common\\Skyrim Special Edition",
-            "E:\\Steam\\steamapps\\common\\Skyrim Special Edition",
-            "E:\\SteamLibrary\\steamapps\\common\\Skyrim Special Edition",
-            "F:\\Steam\\steamapps\\common\\Skyrim Special Edition",
-            "F:\\SteamLibrary\\steamapps\\common\\Skyrim Special Edition",
-            "G:\\Steam\\steamapps\\common\\Skyrim Special Edition",
-            "G:\\SteamLibrary\\steamapps\\common\\Skyrim Special Edition",
-            "C:\\GOG Games\\Skyrim Special Edition",
-            "D:\\GOG Games\\Skyrim Special Edition",
-            "E:\\GOG Games\\Skyrim Special Edition",
-            "C:\\Games\\Skyrim Special Edition",
-            "D:\\Games\\Skyrim Special Edition"
-        };
-
-        for (const auto& pathCandidate : commonPaths) {
-            try {
-                if (fs::exists(pathCandidate) && fs::is_directory(pathCandidate)) {
-                    fs::path testPath = BuildPathCaseInsensitive(
-                        fs::path(pathCandidate), {"Data", "SKSE", "Plugins"}
-                    );
-                    if (IsValidPluginPath(testPath)) {
-                        WriteToSystemLog("Game path detected: Common Installation Path", __LINE__);
-                        return pathCandidate;
-                    }
-                }
-            } catch (...) {
-                continue;
-            }
-        }
-
-        WriteToSystemLog("Attempting DLL Directory Detection (Wabbajack/MO2/Portable fallback)...", __LINE__);
-        fs::path dllDir = GetDllDirectory();
-        
-        if (!dllDir.empty()) {
-            if (IsValidPluginPath(dllDir)) {
-                fs::path calculatedGamePath = dllDir.parent_path().parent_path().parent_path();
-                WriteToSystemLog("Game path detected: DLL Directory Method (Wabbajack/Portable)", __LINE__);
-                WriteToSystemLog("Calculated game path: " + calculatedGamePath.string(), __LINE__);
-                return calculatedGamePath.string();
-            }
-        }
-
-        WriteToSystemLog("WARNING: No valid game path detected, using default fallback", __LINE__);
-        return "C:\\Program Files (x86)\\Steam\\steamapps\\common\\Skyrim Special Edition";
-        
-    } catch (...) {
-        return "";
-    }
-}
-
-SKSELogsPaths GetAllSKSELogsPaths() {
-    SKSELogsPaths paths;
-
-    try {
-        std::string docs = GetDocumentsPath();
-
-        fs::path primaryBase = fs::path(docs) / "My Games" / "Skyrim Special Edition" / "SKSE";
-        paths.primary = primaryBase;
-
-        fs::path secondaryBase = fs::path(docs) / "My Games" / "Skyrim.INI" / "SKSE";
-        paths.secondary = secondaryBase;
-
-        if (fs::exists(paths.primary)) {
-            logger::info("Primary path exists and is accessible");
-        }
-
-        if (fs::exists(paths.secondary)) {
-            logger::info("Secondary path exists and is accessible");
-        }
-
-    } catch (const std::exception& e) {
-        logger::error("Error detecting SKSE paths: {}", e.what());
-    }
-
-    return paths;
-}
-
-void SaveDefaultConfiguration() {
-    fs::path iniPath = GetPluginINIPath();
-    
-    std::ofstream iniFile(iniPath, std::ios::trunc);
-    if (!iniFile.is_open()) {
-        logger::error("Failed to create default configuration file");
-        return;
-    }
-
-    iniFile << "[Quest]" << std::endl;
-    iniFile << "Enabled=true" << std::endl;
-    iniFile << "QuestEditorID=YW_Quest_MDF" << std::endl;
-    iniFile << "QuestPlugin=YurianaWench.esp" << std::endl;
-    iniFile << "TriggerStage=21" << std::endl;
-    iniFile << "CompletionStage=30" << std::endl;
-    iniFile << "ShowNotification=true" << std::endl;
-    iniFile << std::endl;
-
-    iniFile << "[Item]" << std::endl;
-    iniFile << "Enabled=true" << std::endl;
-    iniFile << "ItemID=625C7C" << std::endl;
-    iniFile << "ItemPlugin=YurianaWench.esp" << std::endl;
-    iniFile << "ItemName=Lelyna's Remedy" << std::endl;
-    iniFile << "RemoveOnDetection=true" << std::endl;
-    iniFile << "ShowNotification=true" << std::endl;
-    iniFile << std::endl;
-
-    iniFile << "[Messages]" << std::endl;
-    iniFile << "Enabled=true" << std::endl;
-    iniFile << "TriggerMessage=You must craft Lelyna's Remedy to cure Elora. Check your inventory for the recipe." << std::endl;
-    iniFile << "CompletionMessage=You have crafted the potion and the temple girls are very happy. You have saved Elora!" << std::endl;
-    iniFile << "ShowTriggerMessage=true" << std::endl;
-    iniFile << "ShowCompletionMessage=true" << std::endl;
-    iniFile << std::endl;
-
-    iniFile << "[Monitoring]" << std::endl;
-    iniFile << "Enabled=true" << std::endl;
-    iniFile << "CheckIntervalMs=1000" << std::endl;
-    iniFile << "MaxDetectionDistance=5000.0" << std::endl;
-    iniFile << std::endl;
-
-    iniFile << "[Notification]" << std::endl;
-    iniFile << "Enabled=true" << std::endl;
-
-    iniFile.close();
-}
-
-bool LoadConfiguration() {
-    std::lock_guard<std::mutex> lock(g_configMutex);
-
-    fs::path iniPath = GetPluginINIPath();
-
-    if (!fs::exists(iniPath)) {
-        SaveDefaultConfiguration();
-    }
-
-    std::ifstream iniFile(iniPath);
-    if (!iniFile.is_open()) {
-        logger::error("Failed to open configuration file");
-        return false;
-    }
-
-    std::string line;
-    std::string currentSection;
-
-    while (std::getline(iniFile, line)) {
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
-
-        if (line.empty() || line[0] == ';' || line[0] == '#') {
-            continue;
-        }
-
-        if (line[0] == '[' && line[line.length() - 1] == ']') {
-            currentSection = line.substr(1, line.length() - 2);
-            continue;
-        }
-
-        size_t equalPos = line.find('=');
-        if (equalPos != std::string::npos) {
-            std::string key = line.substr(0, equalPos);
-            std::string value = line.substr(equalPos + 1);
-
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t") + 1);
-
-            if (currentSection == "Quest") {
-                if (key == "Enabled") {
-                    g_config.quest.enabled = (value == "1" || value == "true" || value == "True");
-                } else if (key == "QuestEditorID") {
-                    g_config.quest.questEditorID = value;
-                } else if (key == "QuestPlugin") {
-                    g_config.quest.questPlugin = value;
-                } else if (key == "TriggerStage") {
-                    g_config.quest.triggerStage = std::stoi(value);
-                } else if (key == "CompletionStage") {
-                    g_config.quest.completionStage = std::stoi(value);
-                } else if (key == "ShowNotification") {
-                    g_config.quest.showNotification = (value == "1" || value == "true" || value == "True");
-                }
-            } else if (currentSection == "Item") {
-                if (key == "Enabled") {
-                    g_config.item.enabled = (value == "1" || value == "true" || value == "True");
-                } else if (key == "ItemID") {
-                    g_config.item.itemID = value;
-                } else if (key == "ItemPlugin") {
-                    g_config.item.itemPlugin = value;
-                } else if (key == "ItemName") {
-                    g_config.item.itemName = value;
-                } else if (key == "RemoveOnDetection") {
-                    g_config.item.removeOnDetection = (value == "1" || value == "true" || value == "True");
-                } else if (key == "ShowNotification") {
-                    g_config.item.showNotification = (value == "1" || value == "true" || value == "True");
-                }
-            } else if (currentSection == "Messages") {
-                if (key == "Enabled") {
-                    g_config.messages.enabled = (value == "1" || value == "true" || value == "True");
-                } else if (key == "TriggerMessage") {
-                    g_config.messages.triggerMessage = value;
-                } else if (key == "CompletionMessage") {
-                    g_config.messages.completionMessage = value;
-                } else if (key == "ShowTriggerMessage") {
-                    g_config.messages.showTriggerMessage = (value == "1" || value == "true" || value == "True");
-                } else if (key == "ShowCompletionMessage") {
-                    g_config.messages.showCompletionMessage = (value == "1" || value == "true" || value == "True");
-                }
-            } else if (currentSection == "Monitoring") {
-                if (key == "Enabled") {
-                    g_config.monitoring.enabled = (value == "1" || value == "true" || value == "True");
-                } else if (key == "CheckIntervalMs") {
-                    g_config.monitoring.checkIntervalMs = std::stoi(value);
-                } else if (key == "MaxDetectionDistance") {
-                    g_config.monitoring.maxDetectionDistance = std::stof(value);
-                }
-            } else if (currentSection == "Notification") {
-                if (key == "Enabled") {
-                    g_config.notification.enabled = (value == "1" || value == "true" || value == "True");
-                }
-            }
-        }
-    }
-
-    iniFile.close();
-    return true;
-}
-
-void ValidatePluginsInINI() {
-    auto* dataHandler = RE::TESDataHandler::GetSingleton();
-    if (!dataHandler) {
-        return;
-    }
-
-    bool needsUpdate = false;
-
-    if (g_config.quest.enabled) {
-        auto* questPlugin = dataHandler->LookupModByName(g_config.quest.questPlugin);
-        if (!questPlugin) {
-            g_config.quest.enabled = false;
-            needsUpdate = true;
-            WriteToActionsLog("Plugin not found: " + g_config.quest.questPlugin + " - Disabled [Quest] in memory", __LINE__);
-        }
-    }
-
-    if (g_config.item.enabled) {
-        auto* itemPlugin = dataHandler->LookupModByName(g_config.item.itemPlugin);
-        if (!itemPlugin) {
-            g_config.item.enabled = false;
-            needsUpdate = true;
-            WriteToActionsLog("Plugin not found: " + g_config.item.itemPlugin + " - Disabled [Item] in memory", __LINE__);
-        }
-    }
-
-    if (needsUpdate) {
-        WriteToActionsLog("Plugin validation completed - Some features disabled in memory due to missing plugins", __LINE__);
-        WriteToActionsLog("User INI files preserved - NO modifications made to configuration files", __LINE__);
-    }
-}
-
-void ResolveFormIDs() {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-
-    if (g_config.item.enabled && !g_cachedFormIDs.itemResolved) {
-        g_cachedFormIDs.itemFormID = GetFormIDFromPlugin(g_config.item.itemPlugin, g_config.item.itemID);
-        if (g_cachedFormIDs.itemFormID != 0) {
-            g_cachedFormIDs.itemResolved = true;
-            std::stringstream ss;
-            ss << "Item (" << g_config.item.itemName << ") resolved successfully - FormID: 0x" 
-               << std::hex << std::uppercase << g_cachedFormIDs.itemFormID;
-            WriteToActionsLog(ss.str(), __LINE__);
-        } else {
-            WriteToActionsLog("WARNING: Item (" + g_config.item.itemName + ") FormID resolution failed", __LINE__);
-        }
-    }
-
-    if (g_config.quest.enabled && !g_cachedFormIDs.questResolved) {
-        auto* quest = GetQuestByEditorID(g_config.quest.questEditorID);
-        if (quest) {
-            g_cachedFormIDs.questFormID = quest->GetFormID();
-            g_cachedFormIDs.questResolved = true;
-            std::stringstream ss;
-            ss << "Quest (" << g_config.quest.questEditorID << ") resolved successfully - FormID: 0x" 
-               << std::hex << std::uppercase << g_cachedFormIDs.questFormID;
-            WriteToQuestLog(ss.str(), __LINE__);
-        } else {
-            WriteToQuestLog("WARNING: Quest (" + g_config.quest.questEditorID + ") not found", __LINE__);
-        }
-    }
-}
-
-void CheckQuestState() {
-    if (!g_config.quest.enabled) return;
-    if (g_questState.completionDone) return;
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_lastQuestCheck).count();
-    
-    if (elapsed < g_config.monitoring.checkIntervalMs) {
-        return;
-    }
-    
-    g_lastQuestCheck = now;
-
-    auto* quest = GetQuestByEditorID(g_config.quest.questEditorID);
-    if (!quest) {
-        if (g_questState.questActive) {
-            WriteToQuestLog("Quest no longer accessible: " + g_config.quest.questEditorID, __LINE__);
-            g_questState.questActive = false;
-        }
-        return;
-    }
-
-    bool isRunning = quest->IsRunning();
-    int currentStage = GetQuestCurrentStage(quest);
-
-    if (!g_questState.questActive && isRunning) {
-        g_questState.questActive = true;
-        g_questState.currentStage = currentStage;
-        WriteToQuestLog("========================================", __LINE__);
-        WriteToQuestLog("QUEST ACTIVATED", __LINE__);
-        WriteToQuestLog("Quest: " + g_config.quest.questEditorID, __LINE__);
-        WriteToQuestLog("Current Stage: " + std::to_string(currentStage), __LINE__);
-        WriteToQuestLog("Trigger Stage: " + std::to_string(g_config.quest.triggerStage), __LINE__);
-        WriteToQuestLog("========================================", __LINE__);
-    }
-
-    if (g_questState.questActive && currentStage != g_questState.currentStage) {
-        WriteToQuestLog("Quest stage changed: " + std::to_string(g_questState.currentStage) + 
-                        " -> " + std::to_string(currentStage), __LINE__);
-        g_questState.currentStage = currentStage;
-    }
-
-    if (g_questState.questActive && !g_questState.triggerStageReached) {
-        if (currentStage >= g_config.quest.triggerStage) {
-            ProcessQuestTrigger();
-        }
-    }
-
-    if (!isRunning && g_questState.questActive) {
-        g_questState.questActive = false;
-        WriteToQuestLog("Quest is no longer running: " + g_config.quest.questEditorID, __LINE__);
-    }
-}
-
-void ProcessQuestTrigger() {
-    std::lock_guard<std::mutex> lock(g_questMutex);
-
-    if (g_questState.triggerStageReached) return;
-
-    g_questState.triggerStageReached = true;
-
-    WriteToQuestLog("========================================", __LINE__);
-    WriteToQuestLog("TRIGGER STAGE REACHED", __LINE__);
-    WriteToQuestLog("Quest: " + g_config.quest.questEditorID, __LINE__);
-    WriteToQuestLog("Stage: " + std::to_string(g_config.quest.triggerStage), __LINE__);
-    WriteToQuestLog("========================================", __LINE__);
-
-    if (g_config.messages.enabled && g_config.messages.showTriggerMessage && !g_triggerMessageShown) {
-        g_triggerMessageShown = true;
-        ShowMessageBox(g_config.messages.triggerMessage);
-        WriteToActionsLog("Trigger message displayed to player", __LINE__);
-    }
-
-    if (g_config.notification.enabled && g_config.quest.showNotification) {
-        ShowNotificationMessage("BWY-Fix - Quest stage " + std::to_string(g_config.quest.triggerStage) + " reached");
-    }
-
-    WriteToActionsLog("Now monitoring player inventory for: " + g_config.item.itemName, __LINE__);
-}
-
-void CheckPlayerInventory() {
-    if (!g_config.item.enabled) return;
-    if (!g_questState.triggerStageReached) return;
-    if (g_questState.itemDetected) return;
-    if (g_questState.completionDone) return;
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_lastItemCheck).count();
-    
-    if (elapsed < g_config.monitoring.checkIntervalMs) {
-        return;
-    }
-    
-    g_lastItemCheck = now;
-
-    if (!g_cachedFormIDs.itemResolved) {
-        ResolveFormIDs();
-        if (!g_cachedFormIDs.itemResolved) {
-            return;
-        }
-    }
-
-    if (PlayerHasItem(g_cachedFormIDs.itemFormID)) {
-        ProcessItemDetection();
-    }
-}
-
-void ProcessItemDetection() {
-    std::lock_guard<std::mutex> lock(g_questMutex);
-
-    if (g_questState.itemDetected) return;
-    if (g_waitingForPotionDelay) return;
-
-    g_questState.itemDetected = true;
-    g_waitingForPotionDelay = true;
-    g_potionDetectedTime = std::chrono::steady_clock::now();
-
-    WriteToActionsLog("========================================", __LINE__);
-    WriteToActionsLog("ITEM DETECTED IN PLAYER INVENTORY", __LINE__);
-    WriteToActionsLog("Item: " + g_config.item.itemName, __LINE__);
-    std::stringstream ss;
-    ss << "FormID: 0x" << std::hex << std::uppercase << g_cachedFormIDs.itemFormID;
-    WriteToActionsLog(ss.str(), __LINE__);
-    WriteToActionsLog("Waiting 5 seconds before processing...", __LINE__);
-    WriteToActionsLog("========================================", __LINE__);
-
-    if (!g_potionDetectedMessageShown) {
-        g_potionDetectedMessageShown = true;
-        ShowNotificationMessage("BWY FIX: Potion detected to cure the priestess. Wait for Yulia to take it.");
-    }
-}
-
-void ProcessDelayedQuestCompletion() {
-    if (!g_waitingForPotionDelay) return;
-    if (!g_questState.itemDetected) return;
-    if (g_questState.completionDone) return;
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - g_potionDetectedTime).count();
-
-    if (elapsed < 5) {
-        return;
-    }
-
-    g_waitingForPotionDelay = false;
-
-    WriteToActionsLog("========================================", __LINE__);
-    WriteToActionsLog("5 SECOND DELAY COMPLETE - PROCESSING QUEST", __LINE__);
-    WriteToActionsLog("========================================", __LINE__);
-
-    if (g_config.item.removeOnDetection) {
-        if (RemoveItemFromPlayer(g_cachedFormIDs.itemFormID, 1)) {
-            WriteToActionsLog("Item successfully removed from player inventory", __LINE__);
-        } else {
-            WriteToActionsLog("WARNING: Failed to remove item from player inventory", __LINE__);
-        }
-    }
-
-    ProcessQuestCompletion();
-}
-
-void ProcessQuestCompletion() {
-    if (g_questState.completionDone) return;
-
-    WriteToQuestLog("========================================", __LINE__);
-    WriteToQuestLog("PROCESSING QUEST COMPLETION VIA CONSOLE", __LINE__);
-    WriteToQuestLog("Quest: " + g_config.quest.questEditorID, __LINE__);
-    WriteToQuestLog("Target Stage: " + std::to_string(g_config.quest.completionStage), __LINE__);
-    WriteToQuestLog("========================================", __LINE__);
-
-    SetQuestStageViaConsole(g_config.quest.questEditorID, g_config.quest.completionStage);
-
-    g_questState.completionDone = true;
-
-    WriteToQuestLog("Console command sent successfully", __LINE__);
-
-    if (g_config.messages.enabled && g_config.messages.showCompletionMessage && !g_completionMessageShown) {
-        g_completionMessageShown = true;
-        ShowNotificationMessage(g_config.messages.completionMessage);
-        WriteToActionsLog("Completion notification displayed to player", __LINE__);
-    }
-
-    WriteToActionsLog("========================================", __LINE__);
-    WriteToActionsLog("QUEST FIX COMPLETED SUCCESSFULLY", __LINE__);
-    WriteToActionsLog("Quest: " + g_config.quest.questEditorID, __LINE__);
-    WriteToActionsLog("Final Stage: " + std::to_string(g_config.quest.completionStage), __LINE__);
-    WriteToActionsLog("========================================", __LINE__);
-}
-
-// ===== GAME EVENT PROCESSOR =====
-class GameEventProcessor : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
-    GameEventProcessor() = default;
-    ~GameEventProcessor() = default;
-    GameEventProcessor(const GameEventProcessor&) = delete;
-    GameEventProcessor(GameEventProcessor&&) = delete;
-    GameEventProcessor& operator=(const GameEventProcessor&) = delete;
-    GameEventProcessor& operator=(GameEventProcessor&&) = delete;
-
-public:
-    static GameEventProcessor& GetSingleton() {
-        static GameEventProcessor singleton;
-        return singleton;
-    }
-
-    RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* event,
-                                          RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
-        if (event) {
-            std::stringstream msg;
-            msg << "Menu " << event->menuName.c_str() << " " << (event->opening ? "opened" : "closed");
-            WriteToActionsLog(msg.str(), __LINE__);
-        }
-        return RE::BSEventNotifyControl::kContinue;
-    }
-};
-
-// ===== CONTAINER CHANGE EVENT SINK FOR INVENTORY MONITORING =====
-class ContainerChangeEventSink : public RE::BSTEventSink<RE::TESContainerChangedEvent> {
-    ContainerChangeEventSink() = default;
-    ~ContainerChangeEventSink() = default;
-    ContainerChangeEventSink(const ContainerChangeEventSink&) = delete;
-    ContainerChangeEventSink(ContainerChangeEventSink&&) = delete;
-    ContainerChangeEventSink& operator=(const ContainerChangeEventSink&) = delete;
-    ContainerChangeEventSink& operator=(ContainerChangeEventSink&&) = delete;
-
-public:
-    static ContainerChangeEventSink& GetSingleton() {
-        static ContainerChangeEventSink singleton;
-        return singleton;
-    }
-
-    RE::BSEventNotifyControl ProcessEvent(const RE::TESContainerChangedEvent* event,
-                                          RE::BSTEventSource<RE::TESContainerChangedEvent>*) override {
-        if (!event) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        if (!g_questState.triggerStageReached || g_questState.itemDetected || g_questState.completionDone) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        auto* player = RE::PlayerCharacter::GetSingleton();
-        if (!player) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        RE::FormID playerFormID = player->GetFormID();
-
-        if (event->newContainer == playerFormID) {
-            if (g_cachedFormIDs.itemResolved && event->baseObj == g_cachedFormIDs.itemFormID) {
-                WriteToActionsLog("========================================", __LINE__);
-                WriteToActionsLog("CONTAINER CHANGE EVENT - ITEM ADDED TO PLAYER", __LINE__);
-                std::stringstream ss;
-                ss << "Item FormID: 0x" << std::hex << std::uppercase << event->baseObj;
-                WriteToActionsLog(ss.str(), __LINE__);
-                WriteToActionsLog("Item Count: " + std::to_string(event->itemCount), __LINE__);
-                WriteToActionsLog("========================================", __LINE__);
-
-                ProcessItemDetection();
-            }
-        }
-
-        return RE::BSEventNotifyControl::kContinue;
-    }
-};
-
-// ===== QUEST STAGE EVENT SINK =====
-class QuestStageEventSink : public RE::BSTEventSink<RE::TESQuestStageEvent> {
-    QuestStageEventSink() = default;
-    ~QuestStageEventSink() = default;
-    QuestStageEventSink(const QuestStageEventSink&) = delete;
-    QuestStageEventSink(QuestStageEventSink&&) = delete;
-    QuestStageEventSink& operator=(const QuestStageEventSink&) = delete;
-    QuestStageEventSink& operator=(QuestStageEventSink&&) = delete;
-
-public:
-    static QuestStageEventSink& GetSingleton() {
-        static QuestStageEventSink singleton;
-        return singleton;
-    }
-
-    RE::BSEventNotifyControl ProcessEvent(const RE::TESQuestStageEvent* event,
-                                          RE::BSTEventSource<RE::TESQuestStageEvent>*) override {
-        if (!event) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        if (!g_config.quest.enabled) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        if (g_questState.completionDone) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        auto* quest = RE::TESForm::LookupByID<RE::TESQuest>(event->formID);
-        if (!quest) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        std::string questEditorID = quest->GetFormEditorID();
-        if (questEditorID.empty()) {
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        if (questEditorID == g_config.quest.questEditorID) {
-            int newStage = static_cast<int>(event->stage);
-
-            WriteToQuestLog("========================================", __LINE__);
-            WriteToQuestLog("QUEST STAGE EVENT RECEIVED", __LINE__);
-            WriteToQuestLog("Quest: " + questEditorID, __LINE__);
-            WriteToQuestLog("New Stage: " + std::to_string(newStage), __LINE__);
-            WriteToQuestLog("========================================", __LINE__);
-
-            g_questState.questActive = true;
-            g_questState.currentStage = newStage;
-
-            if (!g_questState.triggerStageReached && newStage >= g_config.quest.triggerStage) {
-                ProcessQuestTrigger();
-            }
-        }
-
-        return RE::BSEventNotifyControl::kContinue;
-    }
-};
-
-// ===== MONITORING THREAD FUNCTION =====
-void MonitoringThreadFunction() {
-    WriteToSystemLog("Monitoring thread started - Watching quest state and player inventory", __LINE__);
-    WriteToSystemLog("Monitoring on dual paths (Primary & Secondary)", __LINE__);
-    WriteToSystemLog("Primary: " + g_logPaths.primary.string(), __LINE__);
-    WriteToSystemLog("Secondary: " + g_logPaths.secondary.string(), __LINE__);
-    WriteToSystemLog("Waiting 5 seconds before starting quest monitoring", __LINE__);
-
-    g_monitoringStartTime = std::chrono::steady_clock::now();
-    g_initialDelayComplete = false;
-
-    while (g_monitoringActive && !g_isShuttingDown.load()) {
-        
-        if (g_isInGameTransition.load()) {
-            WriteToSystemLog("Game transition detected - monitoring paused", __LINE__);
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
-
-        if (!g_initialDelayComplete) {
-            auto currentTime = std::chrono::steady_clock::now();
-            auto elapsedSeconds =
-                std::chrono::duration_cast<std::chrono::seconds>(currentTime - g_monitoringStartTime).count();
-            if (elapsedSeconds < 5) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
-            } else {
-                g_initialDelayComplete = true;
-                WriteToSystemLog("5-second initial delay complete, starting quest monitoring", __LINE__);
-                
-                ResolveFormIDs();
-            }
-        }
-        
-        g_monitorCycles++;
-        
-        CheckQuestState();
-        CheckPlayerInventory();
-        ProcessDelayedQuestCompletion();
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(g_config.monitoring.checkIntervalMs));
-    }
-
-    WriteToSystemLog("Monitoring thread stopped", __LINE__);
-}
-
-void StartMonitoringThread() {
-    if (!g_monitoringActive) {
-        g_monitoringActive = true;
-        g_monitorCycles = 0;
-        g_initialDelayComplete = false;
-        
-        g_questState.questActive = false;
-        g_questState.triggerStageReached = false;
-        g_questState.itemDetected = false;
-        g_questState.completionDone = false;
-        g_questState.currentStage = 0;
-        
-        g_triggerMessageShown = false;
-        g_completionMessageShown = false;
-        g_potionDetectedMessageShown = false;
-        g_waitingForPotionDelay = false;
-        
-        g_cachedFormIDs.questFormID = 0;
-        g_cachedFormIDs.itemFormID = 0;
-        g_cachedFormIDs.questResolved = false;
-        g_cachedFormIDs.itemResolved = false;
-        
-        g_lastQuestCheck = std::chrono::steady_clock::now();
-        g_lastItemCheck = std::chrono::steady_clock::now();
-        
-        g_monitorThread = std::thread(MonitoringThreadFunction);
-
-        WriteToSystemLog("MONITORING SYSTEM ACTIVATED", __LINE__);
-    }
-}
-
-void StopMonitoringThread() {
-    if (g_monitoringActive) {
-        g_monitoringActive = false;
-        if (g_monitorThread.joinable()) {
-            g_monitorThread.join();
-        }
-        WriteToSystemLog("Monitoring thread stopped and joined", __LINE__);
-    }
-}
-
-// ===== PLUGIN INITIALIZATION =====
-void SetupLog() {
-    auto logsFolder = SKSE::log::log_directory();
-    if (!logsFolder) {
-        SKSE::stl::report_and_fail("SKSE log_directory not provided, logs disabled.");
-        return;
-    }
-    auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
-    auto logFilePath = *logsFolder / std::format("{}.log", pluginName);
-    auto fileLoggerPtr = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true);
-    auto loggerPtr = std::make_shared<spdlog::logger>("log", std::move(fileLoggerPtr));
-    spdlog::set_default_logger(std::move(loggerPtr));
-    spdlog::set_level(spdlog::level::trace);
-    spdlog::flush_on(spdlog::level::info);
-}
-
-void InitializePlugin() {
-    try {
-        LoadConfiguration();
-
-        g_documentsPath = GetDocumentsPath();
-        g_gamePath = GetGamePath();
-        g_logPaths = GetAllSKSELogsPaths();
-
-        if (g_gamePath.empty()) {
-            g_gamePath = "C:\\Program Files (x86)\\Steam\\steamapps\\common\\Skyrim Special Edition";
-        }
-
-        WriteToSystemLog("BWY-multi-Fix-NG Plugin - v6.2.2", __LINE__);
-        WriteToActionsLog("BWY-multi-Fix-NG Actions Monitor - v6.2.2", __LINE__);
-        WriteToQuestLog("BWY-multi-Fix-NG Quest Monitor - v6.2.2", __LINE__);
-
-        WriteToSystemLog("========================================", __LINE__);
-        WriteToSystemLog("PLUGIN CONFIGURATION LOADED", __LINE__);
-        WriteToSystemLog("Quest Monitoring: " + std::string(g_config.quest.enabled ? "Enabled" : "Disabled"), __LINE__);
-        WriteToSystemLog("Quest EditorID: " + g_config.quest.questEditorID, __LINE__);
-        WriteToSystemLog("Quest Plugin: " + g_config.quest.questPlugin, __LINE__);
-        WriteToSystemLog("Trigger Stage: " + std::to_string(g_config.quest.triggerStage), __LINE__);
-        WriteToSystemLog("Completion Stage: " + std::to_string(g_config.quest.completionStage), __LINE__);
-        WriteToSystemLog("Item Monitoring: " + std::string(g_config.item.enabled ? "Enabled" : "Disabled"), __LINE__);
-        WriteToSystemLog("Item ID: " + g_config.item.itemID, __LINE__);
-        WriteToSystemLog("Item Plugin: " + g_config.item.itemPlugin, __LINE__);
-        WriteToSystemLog("Item Name: " + g_config.item.itemName, __LINE__);
-        WriteToSystemLog("========================================", __LINE__);
-
-        g_isInitialized = true;
-
-        StartMonitoringThread();
-
-    } catch (const std::exception& e) {
-        logger::error("CRITICAL ERROR in Initialize: {}", e.what());
-    }
-}
-
-void ShutdownPlugin() {
-    WriteToSystemLog("PLUGIN SHUTTING DOWN", __LINE__);
-    WriteToActionsLog("PLUGIN SHUTTING DOWN", __LINE__);
-    WriteToQuestLog("PLUGIN SHUTTING DOWN", __LINE__);
-
-    g_isShuttingDown = true;
-
-    auto* eventSourceHolder = RE::ScriptEventSourceHolder::GetSingleton();
-    if (eventSourceHolder) {
-        eventSourceHolder->RemoveEventSink(&ContainerChangeEventSink::GetSingleton());
-        eventSourceHolder->RemoveEventSink(&QuestStageEventSink::GetSingleton());
-        WriteToSystemLog("Event sinks unregistered", __LINE__);
-    }
-
-    StopMonitoringThread();
-
-    WriteToSystemLog("========================================", __LINE__);
-    WriteToSystemLog("Plugin shutdown complete at: " + GetCurrentTimeString(), __LINE__);
-    WriteToSystemLog("========================================", __LINE__);
-    
-    WriteToQuestLog("========================================", __LINE__);
-    WriteToQuestLog("Plugin shutdown complete at: " + GetCurrentTimeString(), __LINE__);
-    WriteToQuestLog("========================================", __LINE__);
-
-    WriteToActionsLog("========================================", __LINE__);
-    WriteToActionsLog("Plugin shutdown complete at: " + GetCurrentTimeString(), __LINE__);
-    WriteToActionsLog("========================================", __LINE__);
-}
-
-// ===== MODIFIED MAIN FUNCTION WITH IMPROVED DETECTION FOR WABBAJACK/MO2 =====
-void MessageListener(SKSE::MessagingInterface::Message* message) {
-    switch (message->type) {
-        case SKSE::MessagingInterface::kNewGame:
-        case SKSE::MessagingInterface::kPostLoadGame:
-            {
-                WriteToActionsLog("========================================", __LINE__);
-                WriteToActionsLog("SESSION START (New/Load) - Resetting Logic State safely", __LINE__);
-                
-                g_isInGameTransition = false;
-                g_isShuttingDown = false;
-                
-                g_initialDelayComplete = false;
-                
-                g_questState.questActive = false;
-                g_questState.triggerStageReached = false;
-                g_questState.itemDetected = false;
-                g_questState.completionDone = false;
-                g_questState.currentStage = 0;
-                
-                g_triggerMessageShown = false;
-                g_completionMessageShown = false;
-                g_potionDetectedMessageShown = false;
-                g_waitingForPotionDelay = false;
-                
-                g_cachedFormIDs.questFormID = 0;
-                g_cachedFormIDs.itemFormID = 0;
-                g_cachedFormIDs.questResolved = false;
-                g_cachedFormIDs.itemResolved = false;
-                
-                g_lastQuestCheck = std::chrono::steady_clock::now();
-                g_lastItemCheck = std::chrono::steady_clock::now();
-                
-                WriteToActionsLog("Logic reset complete.", __LINE__);
-                
-                if (!g_monitoringActive) {
-                    WriteToActionsLog("Monitoring thread logic: Starting...", __LINE__);
-                    StartMonitoringThread();
-                } else {
-                    WriteToActionsLog("Monitoring thread logic: Already active, continuing.", __LINE__);
-                }
-                
-                WriteToActionsLog("========================================", __LINE__);
-            }
-            break;
-
-        case SKSE::MessagingInterface::kDataLoaded:
-            {
-                auto& eventProcessor = GameEventProcessor::GetSingleton();
-                RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessor);
-                
-                auto* eventSourceHolder = RE::ScriptEventSourceHolder::GetSingleton();
-                if (eventSourceHolder) {
-                    eventSourceHolder->AddEventSink(&ContainerChangeEventSink::GetSingleton());
-                    eventSourceHolder->AddEventSink(&QuestStageEventSink::GetSingleton());
-                    WriteToSystemLog("Container and Quest event sinks registered", __LINE__);
-                }
-                
-                if (!g_isInitialized) {
-                    LoadConfiguration();
-
-                    g_documentsPath = GetDocumentsPath();
-                    g_gamePath = GetGamePath();
-                    g_logPaths = GetAllSKSELogsPaths();
-
-                    if (g_gamePath.empty()) {
-                        g_gamePath = "C:\\Program Files (x86)\\Steam\\steamapps\\common\\Skyrim Special Edition";
-                    }
-                    
-                    WriteToSystemLog("BWY-multi-Fix-NG Plugin - v6.2.2 (DataLoaded)", __LINE__);
-                    g_isInitialized = true;
-                }
-                
-                ValidatePluginsInINI();
-                
-                if (!g_monitoringActive) {
-                    StartMonitoringThread();
-                }
-
-                WriteToSystemLog("========================================", __LINE__);
-                WriteToSystemLog("DATA LOADED - Plugin fully initialized", __LINE__);
-                WriteToSystemLog("Quest to monitor: " + g_config.quest.questEditorID, __LINE__);
-                WriteToSystemLog("Trigger stage: " + std::to_string(g_config.quest.triggerStage), __LINE__);
-                WriteToSystemLog("Completion stage: " + std::to_string(g_config.quest.completionStage), __LINE__);
-                WriteToSystemLog("Item to detect: " + g_config.item.itemName + " (" + g_config.item.itemID + ")", __LINE__);
-                WriteToSystemLog("========================================", __LINE__);
-            }
-            break;
-
-        case SKSE::MessagingInterface::kPreLoadGame:
-            {
-                WriteToActionsLog("Pre-load game detected - preparing for state reset", __LINE__);
-                g_isInGameTransition = true;
-            }
-            break;
-
-        case SKSE::MessagingInterface::kPostLoad:
-            {
-                WriteToSystemLog("Post-load message received", __LINE__);
-            }
-            break;
-
-        case SKSE::MessagingInterface::kInputLoaded:
-            {
-                WriteToSystemLog("Input loaded message received", __LINE__);
-            }
-            break;
-
-        default:
-            break;
-    }
-}
-
-// ===== SKSE PLUGIN LOAD - TRUNCATE LOGS ON GAME START =====
-SKSEPluginLoad(const SKSE::LoadInterface* a_skse) {
-    SKSE::Init(a_skse);
-    SetupLog();
-
-    logger::info("BWY-multi-Fix-NG Plugin v6.2.2 - Starting");
-
-    auto logsFolder = SKSE::log::log_directory();
-    if (logsFolder) {
-        std::ofstream(*logsFolder / "BWY-multi-Fix-NG-Actions.log", std::ios::trunc).close();
-        std::ofstream(*logsFolder / "BWY-multi-Fix-NG-Quest.log", std::ios::trunc).close();
-        std::ofstream(*logsFolder / "BWY-multi-Fix-NG-System.log", std::ios::trunc).close();
-        logger::info("Custom log files truncated successfully");
-    }
-
-    SKSE::GetMessagingInterface()->RegisterListener(MessageListener);
-
-    logger::info("BWY-multi-Fix-NG Plugin loaded successfully");
-    logger::info("Monitoring quest: YW_Quest_MDF");
-    logger::info("Trigger stage: 21, Completion stage: 30");
-    logger::info("Target item: Lelyna's Remedy (625C7C from YurianaWench.esp)");
-
-    return true;
-}
-
-// ===== PLUGIN VERSION DECLARATION =====
-constinit auto SKSEPlugin_Version = []() {
-    SKSE::PluginVersionData v;
-    v.PluginVersion({6, 2, 2});
-    v.PluginName("BWY-multi-Fix-NG Quest Monitor");
-    v.AuthorName("John95AC");
-    v.UsesAddressLibrary();
-    v.UsesSigScanning();
-    v.CompatibleVersions({SKSE::RUNTIME_SSE_LATEST, SKSE::RUNTIME_LATEST_VR});
-
-    return v;
+﻿#include <RE/Skyrim.h>
+#include <SKSE/SKSE.h>
+#include <shlobj.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <windows.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "PluginCore.h"
+
+namespace fs = std::filesystem;
+namespace logger = SKSE::log;
+
+struct SKSELogsPaths {
+    fs::path primary;
+    fs::path secondary;
+};
+
+// Compiled, immutable form of every enabled rule, stored column-wise; rule r owns the required items
+// itemFormIDs[itemOffsets[r] .. itemOffsets[r + 1]).
+struct FixRuleTable : std::enable_shared_from_this<FixRuleTable> {
+    std::vector<std::string> names;
+    std::vector<std::string> questEditorIDs;
+    std::vector<RE::FormID> questFormIDs;
+    std::vector<std::int32_t> triggerStages;
+    std::vector<std::int32_t> completionStages;
+    std::vector<std::int32_t> delayMs;
+    std::vector<std::uint8_t> flags;
+    std::vector<std::string> itemNames;
+    std::vector<std::string> triggerMessages;
+    std::vector<std::string> detectionMessages;
+    std::vector<std::string> completionMessages;
+    std::vector<std::uint32_t> itemOffsets;
+    std::vector<RE::FormID> itemFormIDs;
+
+    FormIDIndex rulesByQuest;
+    FormIDIndex rulesByItem;
+    std::unique_ptr<WatchedItemCounts> inventory;
+    std::unique_ptr<FixRulePhaseWords> phases;  // per-rule progress, updated in place by CAS
+
+    std::uint32_t size() const { return static_cast<std::uint32_t>(triggerStages.size()); }
+};
+
+// Per-rule progress besides the phase, indexed like the published FixRuleTable.
+struct FixRuleStates {
+    std::vector<std::int32_t> stages;
+    std::vector<std::chrono::steady_clock::time_point> detectedAt;
+    std::vector<TimerHandle> completionTimers;
+
+    std::size_t size() const { return stages.size(); }
+
+    void Reset(std::size_t count) {
+        stages.assign(count, 0);
+        detectedAt.assign(count, {});
+        completionTimers.assign(count, {});
+    }
+};
+
+static std::string g_documentsPath;
+static bool g_isInitialized = false;
+static std::mutex g_questMutex;
+static std::mutex g_configMutex;
+static std::mutex g_cacheMutex;
+static std::atomic<bool> g_monitoringActive(false);
+static std::thread g_monitorThread;
+static int g_monitorCycles = 0;
+static std::atomic<std::uint64_t> g_monitorWakeups(0);
+static std::mutex g_monitorMutex;
+static std::condition_variable g_monitorWake;
+static bool g_monitorWakePending = false;  // guarded by g_monitorMutex
+static std::chrono::steady_clock::time_point g_monitoringStartTime;
+static std::atomic<bool> g_initialDelayComplete(false);
+static std::atomic<bool> g_isShuttingDown(false);
+static std::atomic<bool> g_isInGameTransition(false);
+static SKSELogsPaths g_logPaths;
+static SnapshotPublisher<PluginConfig> g_configSnapshots(
+    std::make_shared<const PluginConfig>());  // published under g_configMutex
+static std::atomic<bool> g_dataLoaded(false);
+static std::atomic<bool> g_fixRulesDirty(true);
+static std::atomic<RE::FormID> g_playerFormID(0x14);
+static SnapshotPublisher<FixRuleTable> g_fixRuleSnapshots;  // published under g_questMutex
+static FixRuleStates g_fixRuleStates;  // guarded by g_questMutex
+static TimerWheel g_timerWheel;
+static std::atomic<std::uint32_t> g_sessionGeneration(1);  // bumped per loaded save; never kTimerAnySession
+
+static std::atomic<bool> g_questMonitoringActive(false);
+static std::chrono::steady_clock::time_point g_lastQuestCheck;
+static std::chrono::steady_clock::time_point g_lastItemCheck;
+static std::chrono::steady_clock::time_point g_lastInventoryReconcile;
+
+void StartMonitoringThread();
+void StopMonitoringThread();
+void WakeMonitor();
+void CheckQuestState();
+void CheckPlayerInventory();
+void ReconcileWatchedItems();
+void ProcessQuestTrigger(const FixRuleTable& rules, std::uint32_t rule);
+void ProcessItemDetection(const FixRuleTable& rules, std::uint32_t rule);
+void ProcessQuestCompletion(const FixRuleTable& rules, std::uint32_t rule);
+void CompleteDelayedRule(const FixRuleTable& rules, std::uint32_t rule);
+std::uint32_t CurrentSession();
+void ResolveFormIDs();
+void ValidatePluginsInINI();
+bool LoadConfiguration();
+void SaveDefaultConfiguration();
+fs::path GetPluginINIPath();
+RE::FormID GetFormIDFromPlugin(const std::string& pluginName, const std::string& localFormID);
+RE::TESQuest* GetQuestByEditorID(const std::string& editorID);
+int GetQuestCurrentStage(RE::TESQuest* quest);
+bool RemoveItemFromPlayer(RE::FormID itemFormID, int count = 1, std::function<void(bool)> onComplete = {});
+void ShowNotificationMessage(const std::string& message);
+void ShowMessageBox(const std::string& message);
+
+std::string SafeWideStringToString(const std::wstring& wstr) {
+    if (wstr.empty()) return std::string();
+    try {
+        int size_needed = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), (int)wstr.size(), NULL, 0, NULL, NULL);
+        if (size_needed <= 0) {
+            size_needed = WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), (int)wstr.size(), NULL, 0, NULL, NULL);
+            if (size_needed <= 0) return std::string();
+            std::string result(size_needed, 0);
+            int converted = WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), (int)wstr.size(), &result[0], size_needed, NULL, NULL);
+            if (converted <= 0) return std::string();
+            return result;
+        }
+        std::string result(size_needed, 0);
+        int converted = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), (int)wstr.size(), &result[0], size_needed, NULL, NULL);
+        if (converted <= 0) return std::string();
+        return result;
+    } catch (...) {
+        std::string result;
+        result.reserve(wstr.size());
+        for (wchar_t wc : wstr) {
+            if (wc <= 127) {
+                result.push_back(static_cast<char>(wc));
+            } else {
+                result.push_back('?');
+            }
+        }
+        return result;
+    }
+}
+
+std::string GetEnvVar(const std::string& key) {
+    char* buf = nullptr;
+    size_t sz = 0;
+    if (_dupenv_s(&buf, &sz, key.c_str()) == 0 && buf != nullptr) {
+        std::string value(buf);
+        free(buf);
+        return value;
+    }
+    return "";
+}
+
+std::string NormalizeName(const std::string& name) {
+    std::string normalized = name;
+    normalized.erase(0, normalized.find_first_not_of(" \t\r\n"));
+    normalized.erase(normalized.find_last_not_of(" \t\r\n") + 1);
+    return normalized;
+}
+
+// ===== TIMESTAMP FORMATTING =====
+std::string GetCurrentTimeString() {
+    char buf[kTimestampLength];
+    FormatTimestamp(std::chrono::system_clock::now(), buf);
+    return std::string(buf, kTimestampPrefixLength);
+}
+
+std::string GetCurrentTimeStringWithMillis() {
+    char buf[kTimestampLength];
+    FormatTimestamp(std::chrono::system_clock::now(), buf);
+    return std::string(buf, kTimestampLength);
+}
+
+// ===== ASYNC LOG WRITER =====
+// Calls below this level are compiled out. Release builds keep info and up;
+// define BWY_LOG_COMPILED_MIN_LEVEL to build a verbose release.
+#if defined(BWY_LOG_COMPILED_MIN_LEVEL)
+constexpr LogLevel kCompiledMinLogLevel = static_cast<LogLevel>(BWY_LOG_COMPILED_MIN_LEVEL);
+#elif defined(NDEBUG)
+constexpr LogLevel kCompiledMinLogLevel = LogLevel::Info;
+#else
+constexpr LogLevel kCompiledMinLogLevel = LogLevel::Trace;
+#endif
+
+constexpr auto kLogDrainInterval = std::chrono::milliseconds(20);
+constexpr std::size_t kLogStatsBatchInterval = 2000;  // flushed batches between path statistics lines
+
+enum class LogMirrorMode : std::uint8_t {
+    Sync = 0,
+    Async = 1,
+    Off = 2
+};
+
+struct LogWriterSettings {
+    std::size_t segmentMaxLines = 2500;
+    std::size_t retainedSegments = 3;
+    LogMirrorMode secondaryMirror = LogMirrorMode::Sync;
+    bool writeIndex = true;
+    bool binaryDeferred = false;
+};
+
+// ===== FLIGHT RECORDER =====
+// The recorder file stays mapped for the rest of the process: producers may
+// still log during shutdown and the OS releases the view with the process.
+// Returns nullptr if the file cannot be mapped.
+void* MapFlightRecorderFile(const fs::path& path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    HANDLE mapping =
+        CreateFileMappingW(file, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(kFlightRecorderFileSize), nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return nullptr;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kFlightRecorderFileSize);
+    CloseHandle(mapping);
+    return view;
+}
+
+struct LogPathStats {
+    std::uint64_t bytesWritten = 0;
+    std::uint64_t writeCount = 0;
+    std::uint64_t totalWriteMicros = 0;
+    std::uint64_t maxWriteMicros = 0;
+    std::uint64_t droppedBatches = 0;
+};
+
+std::string FormatLogPathStats(std::string_view label, const LogPathStats& stats) {
+    std::uint64_t averageMicros = stats.writeCount > 0 ? stats.totalWriteMicros / stats.writeCount : 0;
+    return std::format("Log path {}: {} bytes in {} writes, avg {} us, max {} us, {} batches dropped", label,
+                       stats.bytesWritten, stats.writeCount, averageMicros, stats.maxWriteMicros, stats.droppedBatches);
+}
+
+// One log directory: a persistent append handle per channel, segment rotation
+// and write counters. Only one thread writes through it at a time; the
+// counters can be read from anywhere.
+class LogPathWriter {
+public:
+    LogPathWriter() {
+        handles_.fill(INVALID_HANDLE_VALUE);
+        indexHandles_.fill(INVALID_HANDLE_VALUE);
+        binaryHandles_.fill(INVALID_HANDLE_VALUE);
+    }
+    ~LogPathWriter() { CloseAll(); }
+    LogPathWriter(const LogPathWriter&) = delete;
+    LogPathWriter& operator=(const LogPathWriter&) = delete;
+
+    void Configure(const fs::path& path, std::size_t segments, bool writeIndex, bool writeBinary) {
+        directory_ = path;
+        retainedSegments_ = segments;
+        indexEnabled_ = writeIndex;
+        binaryEnabled_ = writeBinary;
+    }
+
+    // Appends data to the live .log and binary (encoded deferred records) to
+    // the live .blog beside it. index entries carry offsets relative to the
+    // start of data, or of binary for kLogIndexBinary entries; they are rebased
+    // onto the segment files and appended to the sidecar index.
+    void Write(LogChannel channel, std::string_view data, std::span<LogIndexEntry> index = {},
+               std::string_view binary = {}) {
+        if (data.empty() && binary.empty()) {
+            return;
+        }
+
+        auto channelIndex = static_cast<std::size_t>(channel);
+        bool textOpen = !data.empty() && OpenSegmentFile(handles_[channelIndex], segmentOffsets_[channelIndex],
+                                                         directory_ / GetLogFileName(channel));
+        bool binaryOpen = !binary.empty() && OpenSegmentFile(binaryHandles_[channelIndex], binaryOffsets_[channelIndex],
+                                                             GetBinaryLogPath(directory_, channel, 0));
+
+        if (indexEnabled_ && !index.empty()) {
+            WriteIndex(channel, index);
+        }
+
+        if (textOpen) {
+            segmentOffsets_[channelIndex] += TimedWrite(handles_[channelIndex], data);
+        }
+        if (binaryOpen) {
+            binaryOffsets_[channelIndex] += TimedWrite(binaryHandles_[channelIndex], binary);
+        }
+    }
+
+    // Closes the live segment and shifts it, with its index and binary log,
+    // into the numbered history. The cost is a fixed number of renames,
+    // independent of segment size; the next write reopens fresh live files.
+    void Rotate(LogChannel channel) {
+        Close(channel);
+
+        ShiftSegments([&](std::size_t index) { return GetLogSegmentPath(directory_, channel, index); });
+        if (indexEnabled_ || retainedSegments_ == 0) {
+            ShiftSegments([&](std::size_t index) { return GetLogIndexPath(directory_, channel, index); });
+        }
+        if (binaryEnabled_) {
+            ShiftSegments([&](std::size_t index) { return GetBinaryLogPath(directory_, channel, index); });
+        }
+    }
+
+    void CloseAll() {
+        for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+            Close(static_cast<LogChannel>(i));
+        }
+    }
+
+    LogPathStats GetStats() const {
+        LogPathStats stats;
+        stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+        stats.writeCount = writeCount_.load(std::memory_order_relaxed);
+        stats.totalWriteMicros = totalWriteMicros_.load(std::memory_order_relaxed);
+        stats.maxWriteMicros = maxWriteMicros_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    // Moves "X.N" to "X.N+1" for one kind of segment file, dropping the oldest,
+    // and the live file (index 0) to "X.1".
+    template <class SegmentPath>
+    void ShiftSegments(SegmentPath&& segmentPath) {
+        std::error_code ec;
+        if (retainedSegments_ == 0) {
+            fs::remove(segmentPath(0), ec);
+            return;
+        }
+
+        fs::remove(segmentPath(retainedSegments_), ec);
+        for (std::size_t index = retainedSegments_; index > 0; --index) {
+            fs::rename(segmentPath(index - 1), segmentPath(index), ec);
+        }
+    }
+
+    // Opens a live segment file on first use and records its current size.
+    static bool OpenSegmentFile(HANDLE& handle, std::uint64_t& offset, const fs::path& path) {
+        if (handle == INVALID_HANDLE_VALUE) {
+            handle = OpenForAppend(path);
+            if (handle == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            LARGE_INTEGER size{};
+            offset = GetFileSizeEx(handle, &size) ? static_cast<std::uint64_t>(size.QuadPart) : 0;
+        }
+        return true;
+    }
+
+    DWORD TimedWrite(HANDLE handle, std::string_view data) {
+        auto start = std::chrono::steady_clock::now();
+        DWORD written = 0;
+        WriteFile(handle, data.data(), static_cast<DWORD>(data.size()), &written, nullptr);
+        auto micros = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+        bytesWritten_.fetch_add(written, std::memory_order_relaxed);
+        writeCount_.fetch_add(1, std::memory_order_relaxed);
+        totalWriteMicros_.fetch_add(micros, std::memory_order_relaxed);
+        if (micros > maxWriteMicros_.load(std::memory_order_relaxed)) {
+            maxWriteMicros_.store(micros, std::memory_order_relaxed);
+        }
+        return written;
+    }
+
+    void WriteIndex(LogChannel channel, std::span<LogIndexEntry> index) {
+        auto channelIndex = static_cast<std::size_t>(channel);
+        HANDLE& indexHandle = indexHandles_[channelIndex];
+        if (indexHandle == INVALID_HANDLE_VALUE) {
+            indexHandle = OpenForAppend(GetLogIndexPath(directory_, channel, 0));
+            if (indexHandle == INVALID_HANDLE_VALUE) {
+                return;
+            }
+        }
+
+        for (auto& entry : index) {
+            entry.offset += (entry.flags & kLogIndexBinary) != 0 ? binaryOffsets_[channelIndex]
+                                                                 : segmentOffsets_[channelIndex];
+        }
+
+        DWORD written = 0;
+        WriteFile(indexHandle, index.data(), static_cast<DWORD>(index.size_bytes()), &written, nullptr);
+    }
+
+    void Close(LogChannel channel) {
+        auto channelIndex = static_cast<std::size_t>(channel);
+        for (HANDLE* handle : {&handles_[channelIndex], &indexHandles_[channelIndex], &binaryHandles_[channelIndex]}) {
+            if (*handle != INVALID_HANDLE_VALUE) {
+                CloseHandle(*handle);
+                *handle = INVALID_HANDLE_VALUE;
+            }
+        }
+        segmentOffsets_[channelIndex] = 0;
+        binaryOffsets_[channelIndex] = 0;
+    }
+
+    static HANDLE OpenForAppend(const fs::path& path) {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        return CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+
+    fs::path directory_;
+    std::size_t retainedSegments_ = 0;
+    bool indexEnabled_ = false;
+    bool binaryEnabled_ = false;
+    std::array<HANDLE, kLogChannelCount> handles_;
+    std::array<HANDLE, kLogChannelCount> indexHandles_;
+    std::array<HANDLE, kLogChannelCount> binaryHandles_;
+    std::array<std::uint64_t, kLogChannelCount> segmentOffsets_{};
+    std::array<std::uint64_t, kLogChannelCount> binaryOffsets_{};
+    std::atomic<std::uint64_t> bytesWritten_{0};
+    std::atomic<std::uint64_t> writeCount_{0};
+    std::atomic<std::uint64_t> totalWriteMicros_{0};
+    std::atomic<std::uint64_t> maxWriteMicros_{0};
+};
+
+constexpr std::size_t kLogMirrorQueueLimit = 256;
+
+// Feeds a LogPathWriter from its own thread so a slow secondary disk never
+// holds up the primary path. Once kLogMirrorQueueLimit batches are waiting,
+// further batches are dropped; rotations are always kept.
+class LogMirrorThread {
+public:
+    void Start(LogPathWriter* writer) {
+        target_ = writer;
+        stopRequested_ = false;
+        mirrorThread_ = std::thread(&LogMirrorThread::ThreadMain, this);
+    }
+
+    void Submit(LogChannel channel, std::string_view data, bool rotateFirst) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (pending_.size() >= kLogMirrorQueueLimit) {
+                droppedBatches_++;
+                if (!rotateFirst) {
+                    return;
+                }
+                data = {};
+            }
+            pending_.push_back({channel, rotateFirst, std::string(data)});
+        }
+        queueCondition_.notify_one();
+    }
+
+    std::size_t GetDroppedBatches() {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        return droppedBatches_;
+    }
+
+    // Writes out everything still queued before returning.
+    void Stop() {
+        if (!mirrorThread_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stopRequested_ = true;
+        }
+        queueCondition_.notify_one();
+        mirrorThread_.join();
+    }
+
+private:
+    struct MirrorBatch {
+        LogChannel channel;
+        bool rotateFirst;
+        std::string data;
+    };
+
+    void ThreadMain() {
+        std::vector<MirrorBatch> working;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                queueCondition_.wait(lock, [this] { return stopRequested_ || !pending_.empty(); });
+                if (pending_.empty()) {
+                    break;
+                }
+                working.swap(pending_);
+            }
+
+            for (auto& batch : working) {
+                if (batch.rotateFirst) {
+                    target_->Rotate(batch.channel);
+                }
+                target_->Write(batch.channel, batch.data);
+            }
+            working.clear();
+        }
+
+        target_->CloseAll();
+    }
+
+    LogPathWriter* target_ = nullptr;
+    std::vector<MirrorBatch> pending_;
+    std::size_t droppedBatches_ = 0;
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    bool stopRequested_ = false;
+    std::thread mirrorThread_;
+};
+
+// Owns the log files. Every channel has its own ring, so threads logging to
+// different channels never touch the same cache lines; a single background
+// thread drains the rings in batches. Each batch is formatted once and handed
+// to the primary path and, synchronously or through the mirror thread, to the
+// secondary path.
+class AsyncLogWriter {
+    AsyncLogWriter() = default;
+    ~AsyncLogWriter() { Stop(); }
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter(AsyncLogWriter&&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(AsyncLogWriter&&) = delete;
+
+public:
+    static AsyncLogWriter& GetSingleton() {
+        static AsyncLogWriter singleton;
+        return singleton;
+    }
+
+    bool Push(LogChannel channel, std::int64_t timestampMs, std::string_view line) {
+        auto& state = channels_[static_cast<std::size_t>(channel)];
+        state.recorder.Record(LogRecordKind::Text, line);
+        return state.ring.TryPush(LogRecordKind::Text, timestampMs, line);
+    }
+
+    bool PushDeferred(LogChannel channel, const DeferredLogRecord& record) {
+        auto& state = channels_[static_cast<std::size_t>(channel)];
+        std::string_view payload(reinterpret_cast<const char*>(&record), sizeof(record));
+        state.recorder.Record(LogRecordKind::Deferred, payload);
+        return state.ring.TryPush(LogRecordKind::Deferred, record.timestampMs, payload);
+    }
+
+    // Records pushed before Start() stay in the ring until the paths are known.
+    void Start(const SKSELogsPaths& paths, const LogWriterSettings& writerSettings) {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        if (writerThread_.joinable()) {
+            return;
+        }
+
+        logPaths_ = paths;
+        settings_ = writerSettings;
+        primaryWriter_.Configure(logPaths_.primary, settings_.retainedSegments, settings_.writeIndex,
+                                 settings_.binaryDeferred);
+        secondaryWriter_.Configure(logPaths_.secondary, settings_.retainedSegments, false, false);
+        OpenFlightRecorders();
+        for (auto& state : channels_) {
+            state.batch.binaryDeferred = settings_.binaryDeferred;
+        }
+
+        if (settings_.secondaryMirror == LogMirrorMode::Async) {
+            secondaryMirror_.Start(&secondaryWriter_);
+        }
+        stopRequested_ = false;
+        writerThread_ = std::thread(&AsyncLogWriter::ThreadMain, this);
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(controlMutex_);
+            if (!writerThread_.joinable()) {
+                return;
+            }
+            stopRequested_ = true;
+        }
+        wakeCondition_.notify_all();
+        writerThread_.join();
+        secondaryMirror_.Stop();
+
+        for (auto& state : channels_) {
+            state.recorder.MarkClean();
+        }
+    }
+
+    LogPathStats GetPrimaryStats() const { return primaryWriter_.GetStats(); }
+    LogPathStats GetSecondaryStats() {
+        LogPathStats stats = secondaryWriter_.GetStats();
+        stats.droppedBatches = secondaryMirror_.GetDroppedBatches();
+        return stats;
+    }
+
+private:
+    struct alignas(64) ChannelState {
+        LogRingBuffer ring;
+        FlightRecorder recorder;
+        LogBatch batch;
+        std::size_t segmentLines = 0;
+    };
+
+    // Saves the tail of a previous session that crashed as "<channel>.crash.log"
+    // before the recorder file is reset for this session.
+    void OpenFlightRecorders() {
+        std::error_code ec;
+        fs::create_directories(logPaths_.primary, ec);
+
+        for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+            auto channel = static_cast<LogChannel>(i);
+            fs::path recorderPath = GetFlightRecorderPath(logPaths_.primary, channel);
+
+            std::vector<std::string> crashTail = FlightRecorder::ReadCrashTail(recorderPath, channel);
+            if (!crashTail.empty()) {
+                std::ofstream crashFile(GetCrashTailPath(logPaths_.primary, channel), std::ios::trunc);
+                for (const auto& line : crashTail) {
+                    crashFile << line << '\n';
+                }
+            }
+
+            if (void* view = MapFlightRecorderFile(recorderPath)) {
+                channels_[i].recorder.Attach(view);
+            }
+        }
+    }
+
+    void ThreadMain() {
+        for (auto& state : channels_) {
+            state.batch.text.reserve(16 * 1024);
+        }
+
+        std::unique_lock<std::mutex> lock(controlMutex_);
+        while (!stopRequested_) {
+            lock.unlock();
+            DrainOnce();
+            lock.lock();
+            wakeCondition_.wait_for(lock, kLogDrainInterval, [this] { return stopRequested_; });
+        }
+        lock.unlock();
+
+        DrainOnce();
+        primaryWriter_.CloseAll();
+        if (settings_.secondaryMirror == LogMirrorMode::Sync) {
+            secondaryWriter_.CloseAll();
+        }
+    }
+
+    void DrainOnce() {
+        for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+            DrainChannel(static_cast<LogChannel>(i));
+        }
+    }
+
+    void DrainChannel(LogChannel channel) {
+        auto& state = channels_[static_cast<std::size_t>(channel)];
+        // Records are captured by the recorder just before they enter the ring, so everything recorded by
+        // now is drained below; a producer caught between the two is the only exception.
+        const std::uint64_t recorded = state.recorder.Sequence();
+        std::size_t drained = state.ring.Drain(
+            [&state, channel](LogRecordKind kind, std::int64_t timestampMs, std::string_view payload) {
+                state.batch.Append(channel, kind, timestampMs, payload);
+            });
+
+        std::size_t dropped = state.ring.TakeDroppedCount();
+        if (dropped > 0) {
+            state.batch.AppendLine("[log writer] WARNING: " + std::to_string(dropped) +
+                                   " log record(s) dropped, ring buffer full");
+        }
+
+        if (drained > 0 || dropped > 0) {
+            FlushChannel(channel);
+        }
+        state.recorder.MarkPersisted(recorded);
+    }
+
+    void FlushChannel(LogChannel channel) {
+        auto& state = channels_[static_cast<std::size_t>(channel)];
+        if (state.batch.text.empty() && state.batch.binary.empty()) {
+            return;
+        }
+
+        bool rotate = state.segmentLines > 0 && state.segmentLines + state.batch.lines > settings_.segmentMaxLines;
+        if (rotate) {
+            primaryWriter_.Rotate(channel);
+            state.segmentLines = 0;
+        }
+
+        primaryWriter_.Write(channel, state.batch.text, state.batch.Seal(channel), state.batch.binary);
+
+        switch (settings_.secondaryMirror) {
+            case LogMirrorMode::Sync:
+                if (rotate) {
+                    secondaryWriter_.Rotate(channel);
+                }
+                secondaryWriter_.Write(channel, state.batch.text);
+                break;
+            case LogMirrorMode::Async:
+                secondaryMirror_.Submit(channel, state.batch.text, rotate);
+                break;
+            default:
+                break;
+        }
+
+        state.segmentLines += state.batch.lines;
+        state.batch.Clear();
+
+        if (rotate || ++batchesSinceStats_ >= kLogStatsBatchInterval) {
+            ReportPathStats();
+        }
+    }
+
+    // Queues the per-path counters on the system channel; the game usually exits without Stop(), so this is
+    // the only place they are ever written.
+    void ReportPathStats() {
+        batchesSinceStats_ = 0;
+        auto now = std::chrono::system_clock::now();
+        auto timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        const std::pair<const char*, LogPathStats> paths[] = {{"primary", GetPrimaryStats()},
+                                                              {"secondary", GetSecondaryStats()}};
+        for (const auto& [label, stats] : paths) {
+            char line[kLogRecordTextSize];
+            std::size_t length = FormatLogLine(line, now, LogChannel::System, LogLevel::Info, __LINE__,
+                                               FormatLogPathStats(label, stats));
+            Push(LogChannel::System, timestampMs, std::string_view(line, length));
+        }
+    }
+
+    std::array<ChannelState, kLogChannelCount> channels_;
+    LogPathWriter primaryWriter_;
+    LogPathWriter secondaryWriter_;
+    LogMirrorThread secondaryMirror_;
+    SKSELogsPaths logPaths_;
+    LogWriterSettings settings_;
+    std::mutex controlMutex_;
+    std::condition_variable wakeCondition_;
+    bool stopRequested_ = false;
+    std::size_t batchesSinceStats_ = 0;
+    std::thread writerThread_;
+};
+
+// ===== LOG SYSTEM =====
+// One bit per (channel, level) pair: bit channel * 8 + level is set when that
+// channel logs at that level. Checking a call is a single load and bit test.
+constexpr std::uint32_t BuildLogFilter(std::uint32_t channelMask, LogLevel minLevel) {
+    std::uint32_t levelBits = (0xFFu << static_cast<std::uint32_t>(minLevel)) & 0xFFu;
+    std::uint32_t filter = 0;
+    for (std::uint32_t channel = 0; channel < kLogChannelCount; ++channel) {
+        if ((channelMask >> channel) & 1u) {
+            filter |= levelBits << (channel * 8);
+        }
+    }
+    return filter;
+}
+
+static std::atomic<std::uint32_t> g_logFilter(BuildLogFilter(0x7, LogLevel::Info));
+
+bool IsLogEnabled(LogChannel channel, LogLevel level) {
+    std::uint32_t bit = static_cast<std::uint32_t>(channel) * 8 + static_cast<std::uint32_t>(level);
+    return (g_logFilter.load(std::memory_order_relaxed) >> bit) & 1u;
+}
+
+void SetLogFilter(std::uint32_t channelMask, LogLevel minLevel) {
+    g_logFilter.store(BuildLogFilter(channelMask, minLevel), std::memory_order_relaxed);
+}
+
+LogLevel ParseLogLevel(std::string_view name, LogLevel fallback) {
+    if (name == "trace" || name == "Trace") return LogLevel::Trace;
+    if (name == "debug" || name == "Debug") return LogLevel::Debug;
+    if (name == "info" || name == "Info") return LogLevel::Info;
+    if (name == "warning" || name == "Warning") return LogLevel::Warning;
+    if (name == "error" || name == "Error") return LogLevel::Error;
+    return fallback;
+}
+
+// Compile-time checked format string that also records the line it was
+// written on, so call sites no longer pass __LINE__.
+template <class... Args>
+struct LogFormatString {
+    template <class T>
+        requires std::convertible_to<const T&, std::string_view>
+    consteval LogFormatString(const T& text, std::source_location location = std::source_location::current())
+        : format(text), lineNumber(location.line()) {}
+
+    std::format_string<Args...> format;
+    std::uint_least32_t lineNumber;
+};
+
+// Formats the prefix and the message straight into a stack buffer and hands
+// it to the async writer; nothing here allocates. Callers go through
+// LogActions/LogQuest/LogSystem, whose Level argument is filtered at compile
+// time against kCompiledMinLogLevel and at run time against g_logFilter.
+template <class... Args>
+void WriteFormattedLog(LogChannel channel, LogLevel level, std::uint_least32_t lineNumber,
+                       std::format_string<Args...> format, Args&&... args) {
+    char line[kLogRecordTextSize];
+    char* const end = line + kLogRecordTextSize;
+
+    auto now = std::chrono::system_clock::now();
+    char* out = FormatLogPrefix(line, now, channel, level, lineNumber);
+    out = std::format_to_n(out, end - out, format, std::forward<Args>(args)...).out;
+
+    auto timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    AsyncLogWriter::GetSingleton().Push(channel, timestampMs, std::string_view(line, out - line));
+}
+
+template <LogLevel Level = LogLevel::Info, class... Args>
+void LogActions(LogFormatString<std::type_identity_t<Args>...> format, Args&&... args) {
+    if constexpr (Level >= kCompiledMinLogLevel) {
+        if (IsLogEnabled(LogChannel::Actions, Level)) {
+            WriteFormattedLog(LogChannel::Actions, Level, format.lineNumber, format.format, std::forward<Args>(args)...);
+        }
+    }
+}
+
+template <LogLevel Level = LogLevel::Info, class... Args>
+void LogQuest(LogFormatString<std::type_identity_t<Args>...> format, Args&&... args) {
+    if constexpr (Level >= kCompiledMinLogLevel) {
+        if (IsLogEnabled(LogChannel::Quest, Level)) {
+            WriteFormattedLog(LogChannel::Quest, Level, format.lineNumber, format.format, std::forward<Args>(args)...);
+        }
+    }
+}
+
+template <LogLevel Level = LogLevel::Info, class... Args>
+void LogSystem(LogFormatString<std::type_identity_t<Args>...> format, Args&&... args) {
+    if constexpr (Level >= kCompiledMinLogLevel) {
+        if (IsLogEnabled(LogChannel::System, Level)) {
+            WriteFormattedLog(LogChannel::System, Level, format.lineNumber, format.format, std::forward<Args>(args)...);
+        }
+    }
+}
+
+struct DeferredLogSite {
+    DeferredLogSite(LogFormatId id, std::source_location location = std::source_location::current())
+        : format(id), lineNumber(location.line()) {}
+
+    LogFormatId format;
+    std::uint_least32_t lineNumber;
+};
+
+// Records a fixed message by format ID; integer arguments are stored raw and
+// formatted later on the writer thread.
+template <LogLevel Level = LogLevel::Info, class... Args>
+void WriteDeferredLog(LogChannel channel, DeferredLogSite site, Args... args) {
+    static_assert(sizeof...(Args) <= kDeferredLogMaxArgs, "Too many deferred log arguments");
+    static_assert((std::is_integral_v<Args> && ...), "Deferred log arguments must be integers");
+
+    if constexpr (Level < kCompiledMinLogLevel) {
+        return;
+    }
+    if (!IsLogEnabled(channel, Level)) {
+        return;
+    }
+
+    DeferredLogRecord record;
+    record.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+    record.format = site.format;
+    record.level = Level;
+    record.lineNumber = static_cast<std::uint32_t>(site.lineNumber);
+    [[maybe_unused]] std::size_t index = 0;
+    ((record.args[index++] = static_cast<std::int64_t>(args)), ...);
+
+    AsyncLogWriter::GetSingleton().PushDeferred(channel, record);
+}
+
+fs::path GetPluginINIPath() {
+    wchar_t exePath[MAX_PATH];
+    GetModuleFileNameW(NULL, exePath, MAX_PATH);
+    fs::path gamePath = fs::path(exePath).parent_path();
+    fs::path pluginConfigDir = gamePath / "Data" / "SKSE" / "Plugins";
+    
+    if (!fs::exists(pluginConfigDir)) {
+        fs::create_directories(pluginConfigDir);
+    }
+    
+    return pluginConfigDir / "BWY-multi-Fix-NG.ini";
+}
+
+// ===== LOADED PLUGIN INDEX =====
+// Case-insensitive name -> TESFile map of every loaded plugin, full and light, built once at kDataLoaded so
+// plugin checks and FormID resolution never walk the data handler's file list.
+class LoadedPluginIndex {
+    LoadedPluginIndex() = default;
+    ~LoadedPluginIndex() = default;
+    LoadedPluginIndex(const LoadedPluginIndex&) = delete;
+    LoadedPluginIndex(LoadedPluginIndex&&) = delete;
+    LoadedPluginIndex& operator=(const LoadedPluginIndex&) = delete;
+    LoadedPluginIndex& operator=(LoadedPluginIndex&&) = delete;
+
+    std::unordered_map<std::string, const RE::TESFile*> files_;
+    std::uint64_t fingerprint_ = 0;
+    std::atomic<bool> built_{false};
+
+public:
+    static LoadedPluginIndex& GetSingleton() {
+        static LoadedPluginIndex singleton;
+        return singleton;
+    }
+
+    // Call once on the main thread before anything reads the index.
+    void Build() {
+        auto* dataHandler = RE::TESDataHandler::GetSingleton();
+        if (!dataHandler || built_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        fingerprint_ = kLoadOrderFingerprintSeed;
+        for (auto* file : dataHandler->files) {
+            if (file && file->compileIndex != 0xFF) {
+                auto [it, inserted] = files_.emplace(FoldPluginName(file->GetFilename()), file);
+                fingerprint_ = HashLoadOrderEntry(fingerprint_, it->first, file->compileIndex,
+                                                  file->smallFileCompileIndex);
+            }
+        }
+        built_.store(true, std::memory_order_release);
+
+        LogSystem("Plugin index built: {} loaded plugins, load order fingerprint {:016X}", files_.size(),
+                  fingerprint_);
+    }
+
+    // Identifies the active load order; changes whenever a plugin is added, removed or moved.
+    std::uint64_t GetFingerprint() const { return fingerprint_; }
+
+    bool IsBuilt() const { return built_.load(std::memory_order_acquire); }
+
+    const RE::TESFile* Find(std::string_view name) const {
+        if (!IsBuilt()) {
+            return nullptr;
+        }
+        auto it = files_.find(FoldPluginName(name));
+        return it != files_.end() ? it->second : nullptr;
+    }
+
+    static RE::FormID EncodeFormID(const RE::TESFile& file, RE::FormID localID) {
+        return ::EncodeFormID(file.compileIndex, file.smallFileCompileIndex, localID);
+    }
+};
+
+struct FormIDRequest {
+    std::string_view plugin;
+    std::string_view localID;
+    RE::FormID formID = 0;
+    std::string_view failure;
+};
+
+// Resolves every request that has no FormID yet against the plugin index in one pass and returns how many
+// failed; each failed request keeps formID 0 and a short reason.
+std::size_t ResolveFormIDBatch(std::span<FormIDRequest> requests) {
+    const auto& plugins = LoadedPluginIndex::GetSingleton();
+    std::size_t failures = 0;
+
+    for (auto& request : requests) {
+        if (request.formID != 0) {
+            continue;
+        }
+
+        RE::FormID localID = 0;
+        const RE::TESFile* file = plugins.Find(request.plugin);
+        if (!file) {
+            request.failure = "plugin not loaded";
+        } else if (!ParseLocalFormID(request.localID, localID)) {
+            request.failure = "invalid FormID";
+        } else {
+            request.formID = LoadedPluginIndex::EncodeFormID(*file, localID);
+            continue;
+        }
+        ++failures;
+    }
+    return failures;
+}
+
+// ===== FORMID CACHE =====
+// One cache per process, loaded with the first rule compile; see FormIDCache in PluginCore.h for the format.
+FormIDCache& GetFormIDCache() {
+    static FormIDCache cache;
+    return cache;
+}
+
+bool IsDLCInstalled(const std::string& dlcName) {
+    return LoadedPluginIndex::GetSingleton().Find(dlcName) != nullptr;
+}
+
+bool IsPluginLoaded(const std::string& pluginName) {
+    return LoadedPluginIndex::GetSingleton().Find(pluginName) != nullptr;
+}
+
+RE::FormID GetFormIDFromPlugin(const std::string& pluginName, const std::string& localFormID) {
+    FormIDRequest request{pluginName, localFormID};
+    if (ResolveFormIDBatch({&request, 1}) != 0) {
+        logger::error("Failed to resolve FormID {}|{}: {}", pluginName, localFormID, request.failure);
+    }
+    return request.formID;
+}
+
+RE::TESQuest* GetQuestByEditorID(const std::string& editorID) {
+    auto* quest = RE::TESForm::LookupByEditorID<RE::TESQuest>(editorID);
+    return quest;
+}
+
+int GetQuestCurrentStage(RE::TESQuest* quest) {
+    if (!quest) return -1;
+    return quest->GetCurrentStageID();
+}
+
+// ===== GAME THREAD COMMAND QUEUE =====
+// Quest stages, item removal, notifications and message boxes touch engine state that is only safe to change
+// on the game thread, yet most of them are decided on the monitor thread. They are queued here and run by a
+// single SKSE task per frame, which executes as many as fit in kGameCommandFrameBudget and leaves the rest for
+// the next frame. Completion callbacks are handed back to the monitor thread through g_timerWheel.
+bool ExecuteGameCommand(GameCommand& command);
+
+class GameCommandQueue {
+    GameCommandQueue() = default;
+    ~GameCommandQueue() = default;
+    GameCommandQueue(const GameCommandQueue&) = delete;
+    GameCommandQueue(GameCommandQueue&&) = delete;
+    GameCommandQueue& operator=(const GameCommandQueue&) = delete;
+    GameCommandQueue& operator=(GameCommandQueue&&) = delete;
+
+    GameCommandRing ring_;
+    std::atomic<bool> drainScheduled_{false};
+
+    void ScheduleDrain() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (drainScheduled_.exchange(true)) {
+            return;
+        }
+        if (auto* tasks = SKSE::GetTaskInterface()) {
+            tasks->AddTask([this] { DrainFrame(); });
+        } else {
+            LogSystem<LogLevel::Error>("SKSE task interface unavailable - running game commands inline");
+            DrainFrame();
+        }
+    }
+
+    void DrainFrame() {
+        std::size_t executed = ring_.RunFrame<std::chrono::steady_clock>(
+            kGameCommandFrameBudget, CurrentSession(), [](GameCommand& command) { return ExecuteGameCommand(command); },
+            &Complete);
+        LogSystem<LogLevel::Trace>("Game thread ran {} queued command(s)", executed);
+
+        // A producer that pushed while the flag was still set skipped scheduling, so look again.
+        drainScheduled_.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring_.Front()) {
+            ScheduleDrain();
+        }
+    }
+
+public:
+    static GameCommandQueue& GetSingleton() {
+        static GameCommandQueue singleton;
+        return singleton;
+    }
+
+    // Runs the callback on the monitor thread, where it is dropped if another save was loaded meanwhile.
+    static void Complete(std::function<void(bool)> onComplete, std::uint32_t generation, bool succeeded) {
+        if (!onComplete) {
+            return;
+        }
+        g_timerWheel.ScheduleAt(std::chrono::steady_clock::now(), generation,
+                                [onComplete = std::move(onComplete), succeeded] { onComplete(succeeded); });
+        WakeMonitor();
+    }
+
+    bool Submit(GameCommand command) {
+        if (command.issuedAt == std::chrono::steady_clock::time_point{}) {
+            command.issuedAt = std::chrono::steady_clock::now();
+        }
+        if (!ring_.TryPush(std::move(command))) {
+            LogActions<LogLevel::Error>("ERROR: Game command queue full - command dropped");
+            Complete(std::move(command.onComplete), command.generation, false);
+            return false;
+        }
+        ScheduleDrain();
+        return true;
+    }
+
+};
+
+bool ExecuteConsoleCommand(const std::string& command) {
+    try {
+        auto* scriptFactory = RE::IFormFactory::GetConcreteFormFactoryByType<RE::Script>();
+        if (!scriptFactory) {
+            LogActions<LogLevel::Error>("ERROR: Failed to get Script factory");
+            return false;
+        }
+        
+        auto* script = scriptFactory->Create();
+        if (!script) {
+            LogActions<LogLevel::Error>("ERROR: Failed to create Script object");
+            return false;
+        }
+        
+        script->SetCommand(command);
+        script->CompileAndRun(nullptr);
+        delete script;
+        
+        LogActions("Console command executed: {}", command);
+        return true;
+    } catch (...) {
+        LogActions<LogLevel::Error>("ERROR: Exception executing console command: {}", command);
+        return false;
+    }
+}
+
+// Asks the game thread to set a quest stage: natively through the quest's Papyrus stage API first, and through
+// a console setstage only when that is refused.
+bool RequestQuestStage(RE::FormID questFormID, const std::string& questEditorID, int stage,
+                       std::function<void(bool)> onComplete = {}) {
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+    LogQuest("REQUESTING QUEST STAGE");
+    LogQuest("Quest: {} (0x{:08X}) stage {}", questEditorID, questFormID, stage);
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+
+    return GameCommandQueue::GetSingleton().Submit(
+        {GameCommandKind::SetStage, questFormID, stage, questEditorID, CurrentSession(), std::move(onComplete)});
+}
+
+// Game thread only; everything else goes through RemoveItemFromPlayer.
+bool RemoveItemFromPlayerNow(RE::FormID itemFormID, int count) {
+    if (itemFormID == 0) return false;
+    
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    if (!player) return false;
+    
+    auto* itemForm = RE::TESForm::LookupByID(itemFormID);
+    if (!itemForm) return false;
+    
+    auto* boundObject = itemForm->As<RE::TESBoundObject>();
+    if (!boundObject) return false;
+    
+    try {
+        player->RemoveItem(boundObject, count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
+        LogActions("Removed {} item(s) from player inventory", count);
+        return true;
+    } catch (...) {
+        LogActions<LogLevel::Error>("Exception while removing item from player inventory");
+        return false;
+    }
+}
+
+bool RemoveItemFromPlayer(RE::FormID itemFormID, int count, std::function<void(bool)> onComplete) {
+    if (itemFormID == 0) return false;
+    return GameCommandQueue::GetSingleton().Submit(
+        {GameCommandKind::RemoveItem, itemFormID, count, {}, CurrentSession(), std::move(onComplete)});
+}
+
+// Messages belong to the session that queued them: one still queued when another save loads is dropped.
+void ShowNotificationMessage(const std::string& message) {
+    if (message.empty()) return;
+    GameCommandQueue::GetSingleton().Submit({GameCommandKind::Notification, 0, 0, message, CurrentSession()});
+}
+
+void ShowMessageBox(const std::string& message) {
+    if (message.empty()) return;
+    GameCommandQueue::GetSingleton().Submit({GameCommandKind::MessageBox, 0, 0, message, CurrentSession()});
+}
+
+// Wraps a stage request's callback so the monitor logs how long the request took on the path that served it.
+std::function<void(bool)> ReportStageLatency(std::string_view path, const GameCommand& command,
+                                             std::function<void(bool)> onComplete) {
+    return [path, questEditorID = command.text, stage = command.count, issuedAt = command.issuedAt,
+            onComplete = std::move(onComplete)](bool succeeded) {
+        double elapsedMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - issuedAt).count();
+        LogQuest("Stage {} of {} {} via {} after {:.2f} ms", stage, questEditorID, succeeded ? "set" : "NOT set",
+                 path, elapsedMs);
+        if (onComplete) {
+            onComplete(succeeded);
+        }
+    };
+}
+
+void FallBackToConsoleStage(GameCommand command) {
+    LogQuest<LogLevel::Warning>("Native stage call refused for {} - falling back to console", command.text);
+    command.onComplete = ReportStageLatency("console", command, std::move(command.onComplete));
+    GameCommandQueue::GetSingleton().Submit(MakeConsoleStageCommand(std::move(command)));
+}
+
+// Receives the result of Quest.SetCurrentStageID, which the VM runs on its own schedule.
+class QuestStageCallback : public RE::BSScript::IStackCallbackFunctor {
+public:
+    explicit QuestStageCallback(GameCommand command) : command_(std::move(command)) {}
+
+    void operator()(RE::BSScript::Variable result) override {
+        if (result.IsBool() && result.GetBool()) {
+            GameCommandQueue::Complete(ReportStageLatency("native", command_, std::move(command_.onComplete)),
+                                       command_.generation, true);
+        } else {
+            FallBackToConsoleStage(std::move(command_));
+        }
+    }
+
+    void SetObject(const RE::BSTSmartPointer<RE::BSScript::Object>&) override {}
+
+private:
+    GameCommand command_;
+};
+
+// Game thread only. Takes over the command's callback; the result arrives through QuestStageCallback.
+bool SetQuestStage(GameCommand& command) {
+    const auto stage = static_cast<std::int32_t>(command.count);
+    auto* quest = command.formID ? RE::TESForm::LookupByID<RE::TESQuest>(command.formID) : nullptr;
+    auto* vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
+    auto* policy = vm ? vm->GetObjectHandlePolicy() : nullptr;
+    RE::VMHandle handle =
+        quest && policy ? policy->GetHandleForObject(static_cast<RE::VMTypeID>(RE::TESQuest::FORMTYPE), quest) : 0;
+
+    RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor> callback(new QuestStageCallback(std::move(command)));
+    command.onComplete = nullptr;
+
+    if (!policy || handle == policy->EmptyHandle()) {
+        (*callback)(RE::BSScript::Variable());
+        return true;
+    }
+
+    // The VM only takes ownership of the arguments when the call is queued.
+    auto* args = RE::MakeFunctionArguments(std::int32_t{stage});
+    if (!vm->DispatchMethodCall(handle, "Quest", "SetCurrentStageID", args, callback)) {
+        delete args;
+        (*callback)(RE::BSScript::Variable());
+    }
+    return true;
+}
+
+bool ExecuteGameCommand(GameCommand& command) {
+    switch (command.kind) {
+        case GameCommandKind::SetStage:
+            return SetQuestStage(command);
+        case GameCommandKind::ConsoleCommand:
+            return ExecuteConsoleCommand(command.text);
+        case GameCommandKind::RemoveItem:
+            return RemoveItemFromPlayerNow(command.formID, command.count);
+        case GameCommandKind::Notification:
+            RE::DebugNotification(command.text.c_str());
+            return true;
+        case GameCommandKind::MessageBox:
+            if (!RE::UIMessageQueue::GetSingleton()) {
+                RE::DebugNotification(command.text.c_str());
+            } else {
+                RE::DebugMessageBox(command.text.c_str());
+            }
+            return true;
+        case GameCommandKind::ReconcileInventory:
+            ReconcileWatchedItems();
+            return true;
+    }
+    return false;
+}
+
+std::string GetDocumentsPath() {
+    try {
+        wchar_t path[MAX_PATH] = {0};
+        HRESULT result = SHGetFolderPathW(NULL, CSIDL_PERSONAL, NULL, SHGFP_TYPE_CURRENT, path);
+        if (SUCCEEDED(result)) {
+            std::wstring ws(path);
+            std::string converted = SafeWideStringToString(ws);
+            if (!converted.empty()) {
+                return converted;
+            }
+        }
+        std::string userProfile = GetEnvVar("USERPROFILE");
+        if (!userProfile.empty()) {
+            return userProfile + "\\Documents";
+        }
+        return "C:\\Users\\Default\\Documents";
+    } catch (...) {
+        return "C:\\Users\\Default\\Documents";
+    }
+}
+
+SKSELogsPaths GetAllSKSELogsPaths() {
+    SKSELogsPaths paths;
+
+    try {
+        std::string docs = GetDocumentsPath();
+
+        fs::path primaryBase = fs::path(docs) / "My Games" / "Skyrim Special Edition" / "SKSE";
+        paths.primary = primaryBase;
+
+        fs::path secondaryBase = fs::path(docs) / "My Games" / "Skyrim.INI" / "SKSE";
+        paths.secondary = secondaryBase;
+
+        if (fs::exists(paths.primary)) {
+            logger::info("Primary path exists and is accessible");
+        }
+
+        if (fs::exists(paths.secondary)) {
+            logger::info("Secondary path exists and is accessible");
+        }
+
+    } catch (const std::exception& e) {
+        logger::error("Error detecting SKSE paths: {}", e.what());
+    }
+
+    return paths;
+}
+
+// ===== INI SCHEMA =====
+// The schema, parser and default writer live in PluginCore.h; this is the
+// part that touches the game's INI file and the SKSE log.
+void WarnInvalidIniValue(std::string_view section, std::string_view key, std::string_view value,
+                         const std::string& kept) {
+    logger::warn("Invalid value for [{}] {}: '{}' - keeping {}", section, key, value, kept);
+}
+
+void SaveDefaultConfiguration() {
+    std::ofstream iniFile(GetPluginINIPath(), std::ios::trunc);
+    if (!iniFile.is_open()) {
+        logger::error("Failed to create default configuration file");
+        return;
+    }
+    WriteDefaultConfiguration(iniFile);
+}
+
+// ===== CONFIGURATION SNAPSHOTS =====
+// The active configuration is an immutable PluginConfig in g_configSnapshots. Readers never lock and keep
+// the snapshot they took alive while they hold it; writers build a complete new snapshot under g_configMutex
+// and publish it.
+std::shared_ptr<const PluginConfig> GetConfig() { return g_configSnapshots.Get(); }
+
+bool ValidatePlugins(PluginConfig& config);
+
+void PublishConfig(std::unique_ptr<const PluginConfig> config) {
+    std::shared_ptr<const PluginConfig> published = g_configSnapshots.Publish(std::move(config));
+    g_fixRulesDirty.store(true, std::memory_order_release);
+    WakeMonitor();
+
+    std::uint32_t channelMask = (published->logging.actionsLog ? 1u : 0u) << static_cast<std::uint32_t>(LogChannel::Actions) |
+                                (published->logging.questLog ? 1u : 0u) << static_cast<std::uint32_t>(LogChannel::Quest) |
+                                (published->logging.systemLog ? 1u : 0u) << static_cast<std::uint32_t>(LogChannel::System);
+    SetLogFilter(channelMask, ParseLogLevel(published->logging.level, LogLevel::Info));
+}
+
+bool LoadConfiguration() {
+    std::lock_guard<std::mutex> lock(g_configMutex);
+
+    fs::path iniPath = GetPluginINIPath();
+
+    if (!fs::exists(iniPath)) {
+        SaveDefaultConfiguration();
+    }
+
+    std::unique_ptr<PluginConfig> config = ReadConfigurationFile(iniPath, WarnInvalidIniValue);
+    if (!config) {
+        logger::error("Failed to open configuration file");
+        return false;
+    }
+
+    if (g_dataLoaded.load(std::memory_order_acquire)) {
+        ValidatePlugins(*config);
+    }
+    PublishConfig(std::move(config));
+
+    return true;
+}
+
+// ===== CONFIGURATION WATCHER =====
+class ConfigWatcher {
+    ConfigWatcher() = default;
+    ~ConfigWatcher() { Stop(); }
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher(ConfigWatcher&&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(ConfigWatcher&&) = delete;
+
+    static constexpr DWORD kDebounceMs = 250;
+
+    std::thread thread_;
+    HANDLE stopEvent_ = nullptr;
+    fs::path iniPath_;
+
+    void ThreadMain() {
+        HANDLE change = FindFirstChangeNotificationW(iniPath_.parent_path().c_str(), FALSE,
+                                                     FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        if (change == INVALID_HANDLE_VALUE) {
+            LogSystem<LogLevel::Warning>("Config watcher unavailable (error {}) - hot reload disabled", GetLastError());
+            return;
+        }
+
+        FileChangeFilter iniChanges(iniPath_);
+        const HANDLE handles[] = {stopEvent_, change};
+
+        while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1) {
+            // Editors often save in several steps (truncate, write, rename); let the burst settle first.
+            if (WaitForSingleObject(stopEvent_, kDebounceMs) == WAIT_OBJECT_0) {
+                break;
+            }
+
+            if (iniChanges.Changed()) {
+                if (LoadConfiguration()) {
+                    LogSystem("Configuration reloaded from {}", iniPath_.filename().string());
+                }
+            }
+
+            if (!FindNextChangeNotification(change)) {
+                break;
+            }
+        }
+
+        FindCloseChangeNotification(change);
+    }
+
+public:
+    static ConfigWatcher& GetSingleton() {
+        static ConfigWatcher singleton;
+        return singleton;
+    }
+
+    void Start(const fs::path& iniPath) {
+        if (thread_.joinable()) {
+            return;
+        }
+        iniPath_ = iniPath;
+        stopEvent_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!stopEvent_) {
+            return;
+        }
+        thread_ = std::thread(&ConfigWatcher::ThreadMain, this);
+        LogSystem("Config watcher started for {}", iniPath_.filename().string());
+    }
+
+    void Stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        SetEvent(stopEvent_);
+        thread_.join();
+        CloseHandle(stopEvent_);
+        stopEvent_ = nullptr;
+    }
+};
+
+LogWriterSettings GetLogWriterSettings() {
+    const std::shared_ptr<const PluginConfig> configSnapshot = GetConfig();
+    const PluginConfig& config = *configSnapshot;
+    LogWriterSettings settings;
+    settings.segmentMaxLines = static_cast<std::size_t>((std::max)(config.logging.segmentMaxLines, 100));
+    settings.retainedSegments = static_cast<std::size_t>(std::clamp(config.logging.retainedSegments, 0, 20));
+    settings.writeIndex = config.logging.writeIndex;
+    settings.binaryDeferred = config.logging.binaryLog;
+    if (config.logging.secondaryMirror == "Async") {
+        settings.secondaryMirror = LogMirrorMode::Async;
+    } else if (config.logging.secondaryMirror == "Off") {
+        settings.secondaryMirror = LogMirrorMode::Off;
+    }
+    return settings;
+}
+
+bool ValidatePlugins(PluginConfig& config) {
+    const auto& plugins = LoadedPluginIndex::GetSingleton();
+    if (!plugins.IsBuilt()) {
+        return false;
+    }
+
+    bool needsUpdate = false;
+
+    if (config.quest.enabled) {
+        auto* questPlugin = plugins.Find(config.quest.questPlugin);
+        if (!questPlugin) {
+            config.quest.enabled = false;
+            needsUpdate = true;
+            LogActions<LogLevel::Warning>("Plugin not found: {} - Disabled [Quest] in memory", config.quest.questPlugin);
+        }
+    }
+
+    if (config.item.enabled) {
+        auto* itemPlugin = plugins.Find(config.item.itemPlugin);
+        if (!itemPlugin) {
+            config.item.enabled = false;
+            needsUpdate = true;
+            LogActions<LogLevel::Warning>("Plugin not found: {} - Disabled [Item] in memory", config.item.itemPlugin);
+        }
+    }
+
+    for (auto& rule : config.fixes) {
+        if (!rule.enabled) {
+            continue;
+        }
+        std::string_view missing;
+        if (!rule.questPlugin.empty() && !plugins.Find(rule.questPlugin)) {
+            missing = rule.questPlugin;
+        }
+        for (const auto& item : ParseRequiredItems(rule.requiredItems)) {
+            if (missing.empty() && !plugins.Find(item.plugin)) {
+                missing = item.plugin;
+            }
+        }
+        if (!missing.empty()) {
+            rule.enabled = false;
+            needsUpdate = true;
+            LogActions<LogLevel::Warning>("Plugin not found: {} - Disabled [{}] in memory", missing, rule.name);
+        }
+    }
+
+    if (needsUpdate) {
+        LogActions("Plugin validation completed - Some features disabled in memory due to missing plugins");
+        LogActions("User INI files preserved - NO modifications made to configuration files");
+    }
+
+    return needsUpdate;
+}
+
+void ValidatePluginsInINI() {
+    std::lock_guard<std::mutex> lock(g_configMutex);
+    g_dataLoaded.store(true, std::memory_order_release);
+
+    auto config = std::make_unique<PluginConfig>(*GetConfig());
+    if (ValidatePlugins(*config)) {
+        PublishConfig(std::move(config));
+    }
+}
+
+// ===== FIX RULE ENGINE =====
+// Every enabled rule ([Quest]/[Item]/[Messages] plus each [Fix.N]) is compiled into one FixRuleTable once the
+// game data is available. The table is published like the config snapshot, and whatever holds an old table
+// (a timer, a game command's callback) keeps it alive until it is done. Each rule's phase is an atomic word
+// on the table itself, and the rest of its progress lives in g_fixRuleStates (guarded by g_questMutex) at the
+// same index.
+std::shared_ptr<const FixRuleTable> GetFixRules() { return g_fixRuleSnapshots.Get(); }
+
+std::uint32_t CurrentSession() { return g_sessionGeneration.load(std::memory_order_acquire); }
+
+// Starts a new session generation so timers armed for the previous save are dropped when they expire.
+void BeginSessionGeneration() {
+    if (g_sessionGeneration.fetch_add(1) + 1 == kTimerAnySession) {
+        g_sessionGeneration.fetch_add(1);
+    }
+}
+
+// Arms the end of a rule's completion delay on the monitor's timer wheel. Caller holds g_questMutex.
+void ArmRuleCompletion(const FixRuleTable& rules, std::uint32_t rule) {
+    g_timerWheel.Cancel(g_fixRuleStates.completionTimers[rule]);
+    auto when = g_fixRuleStates.detectedAt[rule] + std::chrono::milliseconds(rules.delayMs[rule]);
+    g_fixRuleStates.completionTimers[rule] = g_timerWheel.ScheduleAt(
+        when, CurrentSession(), [table = rules.shared_from_this(), rule] { CompleteDelayedRule(*table, rule); });
+}
+
+void CancelRuleCompletions() {
+    for (TimerHandle handle : g_fixRuleStates.completionTimers) {
+        g_timerWheel.Cancel(handle);
+    }
+}
+
+// Moves the progress of rules that survive a rebuild (same section, same quest) onto the new table.
+void PublishFixRules(std::unique_ptr<const FixRuleTable> table) {
+    std::lock_guard<std::mutex> lock(g_questMutex);
+
+    FixRuleStates states;
+    states.Reset(table->size());
+    const std::uint32_t session = CurrentSession();
+
+    if (std::shared_ptr<const FixRuleTable> previous = GetFixRules()) {
+        std::unordered_map<std::string_view, std::uint32_t> previousRules;
+        for (std::uint32_t rule = 0; rule < previous->size(); ++rule) {
+            previousRules.emplace(previous->names[rule], rule);
+        }
+        for (std::uint32_t rule = 0; rule < table->size(); ++rule) {
+            auto it = previousRules.find(table->names[rule]);
+            if (it == previousRules.end() || previous->questEditorIDs[it->second] != table->questEditorIDs[rule] ||
+                it->second >= g_fixRuleStates.size()) {
+                continue;
+            }
+            // A completion already handed to the game thread reports back to the old table; it is done here.
+            FixRulePhase phase = previous->phases->Load(it->second, session);
+            table->phases->Store(rule, phase == FixRulePhase::Completing ? FixRulePhase::Done : phase, session);
+            states.stages[rule] = g_fixRuleStates.stages[it->second];
+            states.detectedAt[rule] = g_fixRuleStates.detectedAt[it->second];
+        }
+    }
+
+    CancelRuleCompletions();
+    g_fixRuleStates = std::move(states);
+    std::shared_ptr<const FixRuleTable> published = g_fixRuleSnapshots.Publish(std::move(table));
+
+    bool armed = false;
+    for (std::uint32_t rule = 0; rule < published->size(); ++rule) {
+        if (published->phases->Load(rule, session) == FixRulePhase::ItemDetected) {
+            ArmRuleCompletion(*published, rule);
+            armed = true;
+        }
+    }
+
+    if (armed) {
+        WakeMonitor();
+    }
+}
+
+// Recounts every watched item in one pass over the player's base container and InventoryChanges entry list,
+// walked in place rather than through GetInventory()'s map, and returns how many counts had drifted. Game
+// thread only: the lists are walked while nothing else can change them, and the counts it stores cannot race
+// a container event's delta. Callers also hold g_questMutex, since every scan shares the table's scratch.
+std::size_t ScanPlayerInventory(const WatchedItemCounts& counts) {
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    if (!player || counts.Empty()) {
+        return 0;
+    }
+
+    counts.BeginScan();
+    if (auto* container = player->GetContainer()) {
+        for (std::uint32_t i = 0; i < container->numContainerObjects; ++i) {
+            auto* entry = container->containerObjects[i];
+            if (entry && entry->obj) {
+                counts.AddBase(entry->obj->GetFormID(), entry->count);
+            }
+        }
+    }
+
+    auto* changes = player->GetInventoryChanges();
+    if (changes && changes->entryList) {
+        for (auto* entry : *changes->entryList) {
+            if (entry && entry->object && counts.AddChange(entry->object->GetFormID(), entry->countDelta)) {
+                break;
+            }
+        }
+    }
+    return counts.CommitScan();
+}
+
+// Called at session start, when the player's inventory belongs to the newly loaded save. The new session
+// generation turns every phase word back to Idle. SKSE delivers these messages on the game thread, so the
+// inventory is recounted directly.
+void ResetFixRuleStates() {
+    std::lock_guard<std::mutex> lock(g_questMutex);
+    std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+    CancelRuleCompletions();
+    BeginSessionGeneration();
+    g_fixRuleStates.Reset(rules ? rules->size() : 0);
+    if (rules) {
+        ScanPlayerInventory(*rules->inventory);
+    }
+    g_lastInventoryReconcile = std::chrono::steady_clock::now();
+}
+
+// Game thread only (a ReconcileInventory command); recounts the published table's watched items.
+void ReconcileWatchedItems() {
+    std::lock_guard<std::mutex> lock(g_questMutex);
+    std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+    if (!rules) {
+        return;
+    }
+    if (std::size_t drifted = ScanPlayerInventory(*rules->inventory)) {
+        LogActions<LogLevel::Debug>("Inventory reconcile corrected {} watched item count(s)", drifted);
+    }
+}
+
+// Counts are only ever recounted on the game thread, where container events are delivered as well.
+void RequestInventoryReconcile() {
+    GameCommandQueue::GetSingleton().Submit({GameCommandKind::ReconcileInventory, 0, 0, {}, CurrentSession()});
+}
+
+// Rebuilds the rule table when the configuration changed since the last build. Rules whose required items
+// cannot be resolved are skipped, since they could never complete.
+void ResolveFormIDs() {
+    if (!g_dataLoaded.load(std::memory_order_acquire) || !g_fixRulesDirty.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    if (!g_fixRulesDirty.exchange(false)) {
+        return;
+    }
+
+    auto table = std::make_unique<FixRuleTable>();
+    table->itemOffsets.push_back(0);
+    std::vector<std::pair<RE::FormID, std::uint32_t>> questEntries;
+    std::vector<std::pair<RE::FormID, std::uint32_t>> itemEntries;
+
+    std::vector<FixRuleConfig> ruleConfigs = CollectFixRules(*GetConfig());
+    std::erase_if(ruleConfigs, [](const FixRuleConfig& rule) { return !rule.enabled || rule.questEditorID.empty(); });
+
+    // Every required item of every rule goes through the resolver in one batch; requestOffsets[r] is where
+    // rule r's requests start.
+    std::vector<FormIDRequest> requests;
+    std::vector<std::size_t> requestOffsets;
+    for (const auto& rule : ruleConfigs) {
+        requestOffsets.push_back(requests.size());
+        for (const auto& item : ParseRequiredItems(rule.requiredItems)) {
+            requests.push_back({item.plugin, item.localID});
+        }
+    }
+    requestOffsets.push_back(requests.size());
+
+    auto& cache = GetFormIDCache();
+    switch (cache.Load(GetPluginINIPath().parent_path() / "BWY-multi-Fix-NG.formcache",
+                       LoadedPluginIndex::GetSingleton().GetFingerprint())) {
+    case FormIDCacheLoad::OtherLoadOrder:
+        LogSystem("FormID cache belongs to a different load order - rebuilding");
+        break;
+    case FormIDCacheLoad::Loaded:
+        LogSystem("FormID cache loaded: {} entries", cache.Size());
+        break;
+    default:
+        break;
+    }
+    std::size_t cacheHits = 0;
+
+    for (auto& request : requests) {
+        RE::FormID cached = cache.Find(FormIDCache::ItemKey(request.plugin, request.localID));
+        if (cached != 0 && RE::TESForm::LookupByID(cached)) {
+            request.formID = cached;
+            ++cacheHits;
+        }
+    }
+
+    if (std::size_t failures = ResolveFormIDBatch(requests)) {
+        std::string summary;
+        for (std::size_t r = 0; r < ruleConfigs.size(); ++r) {
+            for (std::size_t i = requestOffsets[r]; i < requestOffsets[r + 1]; ++i) {
+                if (requests[i].formID == 0) {
+                    summary += std::format("{}[{}] {}|{} ({})", summary.empty() ? "" : "; ", ruleConfigs[r].name,
+                                           requests[i].plugin, requests[i].localID, requests[i].failure);
+                }
+            }
+        }
+        LogActions<LogLevel::Warning>("WARNING: {} of {} item FormIDs failed to resolve, rules skipped: {}", failures,
+                                      requests.size(), summary);
+    }
+
+    for (std::size_t r = 0; r < ruleConfigs.size(); ++r) {
+        const FixRuleConfig& rule = ruleConfigs[r];
+        std::span<const FormIDRequest> items(requests.data() + requestOffsets[r],
+                                             requestOffsets[r + 1] - requestOffsets[r]);
+        if (std::any_of(items.begin(), items.end(), [](const FormIDRequest& item) { return item.formID == 0; })) {
+            continue;
+        }
+
+        for (const auto& item : items) {
+            cache.Store(FormIDCache::ItemKey(item.plugin, item.localID), item.formID);
+        }
+
+        // A cached quest ID is only trusted while it still names the same quest; an ID reused by another
+        // plugin's quest falls through to a fresh editor ID lookup.
+        RE::FormID questFormID = cache.Find(FormIDCache::QuestKey(rule.questEditorID));
+        auto* cachedQuest = questFormID != 0 ? RE::TESForm::LookupByID<RE::TESQuest>(questFormID) : nullptr;
+        const char* cachedEditorID = cachedQuest ? cachedQuest->GetFormEditorID() : nullptr;
+        if (cachedEditorID && _stricmp(cachedEditorID, rule.questEditorID.c_str()) == 0) {
+            ++cacheHits;
+        } else if (auto* quest = GetQuestByEditorID(rule.questEditorID)) {
+            questFormID = quest->GetFormID();
+            cache.Store(FormIDCache::QuestKey(rule.questEditorID), questFormID);
+            LogQuest("Quest ({}) resolved successfully - FormID: 0x{:X}", rule.questEditorID, questFormID);
+        } else {
+            questFormID = 0;
+            LogQuest<LogLevel::Warning>("WARNING: Quest ({}) not found", rule.questEditorID);
+        }
+
+        auto index = static_cast<std::uint32_t>(table->size());
+        table->names.push_back(rule.name);
+        table->questEditorIDs.push_back(rule.questEditorID);
+        table->questFormIDs.push_back(questFormID);
+        table->triggerStages.push_back(rule.triggerStage);
+        table->completionStages.push_back(rule.completionStage);
+        table->delayMs.push_back((std::max)(rule.delayMs, 0));
+        table->flags.push_back(static_cast<std::uint8_t>((rule.removeItems ? kFixRuleRemoveItems : 0) |
+                                                         (rule.showNotification ? kFixRuleShowNotification : 0)));
+        table->itemNames.push_back(rule.itemName);
+        table->triggerMessages.push_back(rule.triggerMessage);
+        table->detectionMessages.push_back(rule.detectionMessage);
+        table->completionMessages.push_back(rule.completionMessage);
+        for (const auto& item : items) {
+            table->itemFormIDs.push_back(item.formID);
+            itemEntries.emplace_back(item.formID, index);
+            LogActions("Item ({}) resolved successfully - FormID: 0x{:X}", rule.itemName, item.formID);
+        }
+        table->itemOffsets.push_back(static_cast<std::uint32_t>(table->itemFormIDs.size()));
+        questEntries.emplace_back(questFormID, index);
+    }
+
+    table->rulesByQuest.Build(std::move(questEntries));
+    table->rulesByItem.Build(std::move(itemEntries));
+
+    if (!cache.Save()) {
+        LogSystem<LogLevel::Warning>("Failed to write FormID cache: {}", cache.Path().string());
+    }
+
+    table->inventory = std::make_unique<WatchedItemCounts>(table->itemFormIDs);
+    table->phases = std::make_unique<FixRulePhaseWords>(table->size());
+
+    LogSystem("Fix rules compiled: {} active, {} watched items, {} FormIDs from cache", table->size(),
+              table->itemFormIDs.size(), cacheHits);
+    PublishFixRules(std::move(table));
+    RequestInventoryReconcile();
+}
+
+// True when the player holds every required item of the rule, according to the watched-item counts.
+// Rules without items are trigger-only and never report their items as found.
+bool HasRequiredItems(const FixRuleTable& rules, std::uint32_t rule) {
+    std::uint32_t first = rules.itemOffsets[rule];
+    std::uint32_t last = rules.itemOffsets[rule + 1];
+    if (first == last) {
+        return false;
+    }
+    for (std::uint32_t i = first; i < last; ++i) {
+        if (rules.inventory->Count(rules.itemFormIDs[i]) <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The rule-indexed functions below expect g_questMutex to be held and rules to be the published table. Each
+// starts with the CAS for its transition, so only one caller ever performs it.
+void ProcessQuestTrigger(const FixRuleTable& rules, std::uint32_t rule) {
+    if (!rules.phases->Transition(rule, FixRulePhase::Active, FixRulePhase::Triggered, CurrentSession())) return;
+
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::TriggerStageReached);
+    LogQuest("Quest: {} [{}]", rules.questEditorIDs[rule], rules.names[rule]);
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Stage, rules.triggerStages[rule]);
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+
+    if (!rules.triggerMessages[rule].empty()) {
+        ShowMessageBox(rules.triggerMessages[rule]);
+        LogActions("Trigger message displayed to player");
+    }
+
+    if (rules.flags[rule] & kFixRuleShowNotification) {
+        ShowNotificationMessage("BWY-Fix - Quest stage " + std::to_string(rules.triggerStages[rule]) + " reached");
+    }
+
+    if (rules.itemOffsets[rule] != rules.itemOffsets[rule + 1]) {
+        LogActions("Now monitoring player inventory for: {}", rules.itemNames[rule]);
+    }
+}
+
+void ProcessItemDetection(const FixRuleTable& rules, std::uint32_t rule) {
+    if (!rules.phases->Transition(rule, FixRulePhase::Triggered, FixRulePhase::ItemDetected, CurrentSession())) {
+        return;
+    }
+
+    g_fixRuleStates.detectedAt[rule] = std::chrono::steady_clock::now();
+    ArmRuleCompletion(rules, rule);
+
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::ItemDetected);
+    LogActions("Item: {} [{}]", rules.itemNames[rule], rules.names[rule]);
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::FormID, rules.itemFormIDs[rules.itemOffsets[rule]]);
+    LogActions("Waiting {} ms before processing...", rules.delayMs[rule]);
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+
+    if (!rules.detectionMessages[rule].empty()) {
+        ShowNotificationMessage(rules.detectionMessages[rule]);
+    }
+}
+
+// The rule is Completing until the game thread has run the setstage command; its callback finishes it.
+void ProcessQuestCompletion(const FixRuleTable& rules, std::uint32_t rule) {
+    const std::uint32_t session = CurrentSession();
+    if (rules.phases->Load(rule, session) != FixRulePhase::Completing) return;
+
+    const std::string& questEditorID = rules.questEditorIDs[rule];
+    int completionStage = rules.completionStages[rule];
+
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+    LogQuest("PROCESSING QUEST COMPLETION");
+    LogQuest("Quest: {} [{}]", questEditorID, rules.names[rule]);
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::TargetStage, completionStage);
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+
+    auto onStageSet = [table = rules.shared_from_this(), rule, session](bool succeeded) {
+        table->phases->Transition(rule, FixRulePhase::Completing, FixRulePhase::Done, session);
+
+        const std::string& quest = table->questEditorIDs[rule];
+        if (!succeeded) {
+            LogQuest<LogLevel::Error>("ERROR: setstage failed for quest {} [{}]", quest, table->names[rule]);
+            return;
+        }
+
+        if (!table->completionMessages[rule].empty()) {
+            ShowNotificationMessage(table->completionMessages[rule]);
+            LogActions("Completion notification displayed to player");
+        }
+
+        WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+        LogActions("QUEST FIX COMPLETED SUCCESSFULLY");
+        LogActions("Quest: {} [{}]", quest, table->names[rule]);
+        WriteDeferredLog(LogChannel::Actions, LogFormatId::FinalStage, table->completionStages[rule]);
+        WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+    };
+    RequestQuestStage(rules.questFormIDs[rule], questEditorID, completionStage, std::move(onStageSet));
+}
+
+void CheckQuestState() {
+    const std::shared_ptr<const PluginConfig> configSnapshot = GetConfig();
+    const PluginConfig& config = *configSnapshot;
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_lastQuestCheck).count();
+    
+    if (elapsed < config.monitoring.checkIntervalMs) {
+        return;
+    }
+    
+    g_lastQuestCheck = now;
+
+    std::lock_guard<std::mutex> lock(g_questMutex);
+    std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+    if (!rules) return;
+    const std::uint32_t session = CurrentSession();
+
+    for (std::uint32_t rule = 0; rule < rules->size(); ++rule) {
+        FixRulePhase phase = rules->phases->Load(rule, session);
+        if (phase == FixRulePhase::Done) continue;
+
+        const std::string& questEditorID = rules->questEditorIDs[rule];
+        auto* quest = rules->questFormIDs[rule] ? RE::TESForm::LookupByID<RE::TESQuest>(rules->questFormIDs[rule])
+                                                : nullptr;
+        if (!quest) {
+            if (rules->phases->Transition(rule, FixRulePhase::Active, FixRulePhase::Idle, session)) {
+                LogQuest("Quest no longer accessible: {}", questEditorID);
+            }
+            continue;
+        }
+
+        bool isRunning = quest->IsRunning();
+        int currentStage = GetQuestCurrentStage(quest);
+
+        if (phase == FixRulePhase::Idle && isRunning &&
+            rules->phases->Transition(rule, FixRulePhase::Idle, FixRulePhase::Active, session)) {
+            phase = FixRulePhase::Active;
+            g_fixRuleStates.stages[rule] = currentStage;
+            WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+            WriteDeferredLog(LogChannel::Quest, LogFormatId::QuestActivated);
+            LogQuest("Quest: {} [{}]", questEditorID, rules->names[rule]);
+            WriteDeferredLog(LogChannel::Quest, LogFormatId::CurrentStage, currentStage);
+            WriteDeferredLog(LogChannel::Quest, LogFormatId::TriggerStage, rules->triggerStages[rule]);
+            WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+        }
+
+        if (phase != FixRulePhase::Idle && currentStage != g_fixRuleStates.stages[rule]) {
+            WriteDeferredLog(LogChannel::Quest, LogFormatId::QuestStageChanged, g_fixRuleStates.stages[rule],
+                             currentStage);
+            g_fixRuleStates.stages[rule] = currentStage;
+        }
+
+        if (phase == FixRulePhase::Active && currentStage >= rules->triggerStages[rule]) {
+            ProcessQuestTrigger(*rules, rule);
+        }
+
+        if (!isRunning && rules->phases->Transition(rule, FixRulePhase::Active, FixRulePhase::Idle, session)) {
+            LogQuest("Quest is no longer running: {}", questEditorID);
+        }
+    }
+}
+
+constexpr auto kInventoryReconcileInterval = std::chrono::seconds(30);
+
+void CheckPlayerInventory() {
+    const std::shared_ptr<const PluginConfig> configSnapshot = GetConfig();
+    const PluginConfig& config = *configSnapshot;
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_lastItemCheck).count();
+    
+    if (elapsed < config.monitoring.checkIntervalMs) {
+        return;
+    }
+    
+    g_lastItemCheck = now;
+
+    std::lock_guard<std::mutex> lock(g_questMutex);
+    std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+    if (!rules) return;
+
+    if (now - g_lastInventoryReconcile >= kInventoryReconcileInterval) {
+        g_lastInventoryReconcile = now;
+        RequestInventoryReconcile();
+    }
+
+    const std::uint32_t session = CurrentSession();
+    for (std::uint32_t rule = 0; rule < rules->size(); ++rule) {
+        if (rules->phases->Load(rule, session) == FixRulePhase::Triggered && HasRequiredItems(*rules, rule)) {
+            ProcessItemDetection(*rules, rule);
+        }
+    }
+}
+
+// Timer wheel action for a rule whose completion delay has run out. The rule table it was armed against
+// may have been replaced since, in which case the re-armed timer on the new table handles it.
+void CompleteDelayedRule(const FixRuleTable& rules, std::uint32_t rule) {
+    std::lock_guard<std::mutex> lock(g_questMutex);
+    if (GetFixRules().get() != &rules ||
+        !rules.phases->Transition(rule, FixRulePhase::ItemDetected, FixRulePhase::Completing, CurrentSession())) {
+        return;
+    }
+
+    g_fixRuleStates.completionTimers[rule] = {};
+
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+    LogActions("DELAY COMPLETE - PROCESSING QUEST [{}]", rules.names[rule]);
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+
+    if (rules.flags[rule] & kFixRuleRemoveItems) {
+        for (std::uint32_t i = rules.itemOffsets[rule]; i < rules.itemOffsets[rule + 1]; ++i) {
+            RemoveItemFromPlayer(rules.itemFormIDs[i], 1, [](bool removed) {
+                if (removed) {
+                    LogActions("Item successfully removed from player inventory");
+                } else {
+                    LogActions<LogLevel::Warning>("WARNING: Failed to remove item from player inventory");
+                }
+            });
+        }
+    }
+
+    ProcessQuestCompletion(rules, rule);
+}
+
+// ===== GAME EVENT PROCESSOR =====
+class GameEventProcessor : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
+    GameEventProcessor() = default;
+    ~GameEventProcessor() = default;
+    GameEventProcessor(const GameEventProcessor&) = delete;
+    GameEventProcessor(GameEventProcessor&&) = delete;
+    GameEventProcessor& operator=(const GameEventProcessor&) = delete;
+    GameEventProcessor& operator=(GameEventProcessor&&) = delete;
+
+public:
+    static GameEventProcessor& GetSingleton() {
+        static GameEventProcessor singleton;
+        return singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* event,
+                                          RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
+        if (event) {
+            LogActions<LogLevel::Debug>("Menu {} {}", event->menuName.c_str(), event->opening ? "opened" : "closed");
+        }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+};
+
+// ===== CONTAINER CHANGE EVENT SINK FOR INVENTORY MONITORING =====
+class ContainerChangeEventSink : public RE::BSTEventSink<RE::TESContainerChangedEvent> {
+    ContainerChangeEventSink() = default;
+    ~ContainerChangeEventSink() = default;
+    ContainerChangeEventSink(const ContainerChangeEventSink&) = delete;
+    ContainerChangeEventSink(ContainerChangeEventSink&&) = delete;
+    ContainerChangeEventSink& operator=(const ContainerChangeEventSink&) = delete;
+    ContainerChangeEventSink& operator=(ContainerChangeEventSink&&) = delete;
+
+public:
+    static ContainerChangeEventSink& GetSingleton() {
+        static ContainerChangeEventSink singleton;
+        return singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESContainerChangedEvent* event,
+                                          RE::BSTEventSource<RE::TESContainerChangedEvent>*) override {
+        const RE::FormID playerFormID = g_playerFormID.load(std::memory_order_relaxed);
+        if (!event || !IsPlayerInventoryChange(event->oldContainer, event->newContainer, playerFormID)) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+        const bool added = event->newContainer == playerFormID;
+        const auto delta = static_cast<std::int32_t>(added ? event->itemCount : -event->itemCount);
+        if (!rules || !rules->inventory->Apply(event->baseObj, delta) || !added) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        // Phases and counts are both lock-free, so the mutex is only taken when a rule can actually advance.
+        const std::uint32_t session = CurrentSession();
+        auto watchers = rules->rulesByItem.Find(event->baseObj);
+        auto ready = [&](std::uint32_t rule) {
+            return rules->phases->Load(rule, session) == FixRulePhase::Triggered && HasRequiredItems(*rules, rule);
+        };
+        if (std::none_of(watchers.begin(), watchers.end(), ready)) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        std::lock_guard<std::mutex> lock(g_questMutex);
+        if (GetFixRules() != rules) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        for (std::uint32_t rule : watchers) {
+            if (!ready(rule)) {
+                continue;
+            }
+
+            WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+            WriteDeferredLog(LogChannel::Actions, LogFormatId::ContainerItemAdded);
+            WriteDeferredLog(LogChannel::Actions, LogFormatId::ItemFormID, event->baseObj);
+            WriteDeferredLog(LogChannel::Actions, LogFormatId::ItemCount, event->itemCount);
+            WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+
+            ProcessItemDetection(*rules, rule);
+            WakeMonitor();
+        }
+
+        return RE::BSEventNotifyControl::kContinue;
+    }
+};
+
+// ===== QUEST STAGE EVENT SINK =====
+class QuestStageEventSink : public RE::BSTEventSink<RE::TESQuestStageEvent> {
+    QuestStageEventSink() = default;
+    ~QuestStageEventSink() = default;
+    QuestStageEventSink(const QuestStageEventSink&) = delete;
+    QuestStageEventSink(QuestStageEventSink&&) = delete;
+    QuestStageEventSink& operator=(const QuestStageEventSink&) = delete;
+    QuestStageEventSink& operator=(QuestStageEventSink&&) = delete;
+
+public:
+    static QuestStageEventSink& GetSingleton() {
+        static QuestStageEventSink singleton;
+        return singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESQuestStageEvent* event,
+                                          RE::BSTEventSource<RE::TESQuestStageEvent>*) override {
+        if (!event) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+        auto watchers = rules ? rules->rulesByQuest.Find(event->formID) : std::span<const std::uint32_t>();
+        const std::uint32_t session = CurrentSession();
+        if (std::all_of(watchers.begin(), watchers.end(), [&](std::uint32_t rule) {
+                return rules->phases->Load(rule, session) == FixRulePhase::Done;
+            })) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        int newStage = static_cast<int>(event->stage);
+
+        WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+        WriteDeferredLog(LogChannel::Quest, LogFormatId::QuestStageEventReceived);
+        LogQuest("Quest: {}", rules->questEditorIDs[watchers.front()]);
+        WriteDeferredLog(LogChannel::Quest, LogFormatId::NewStage, newStage);
+        WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+
+        std::lock_guard<std::mutex> lock(g_questMutex);
+        if (GetFixRules() != rules) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        for (std::uint32_t rule : watchers) {
+            if (rules->phases->Load(rule, session) == FixRulePhase::Done) {
+                continue;
+            }
+
+            g_fixRuleStates.stages[rule] = newStage;
+            rules->phases->Transition(rule, FixRulePhase::Idle, FixRulePhase::Active, session);
+
+            if (newStage >= rules->triggerStages[rule]) {
+                ProcessQuestTrigger(*rules, rule);
+            }
+        }
+
+        WakeMonitor();
+        return RE::BSEventNotifyControl::kContinue;
+    }
+};
+
+// ===== MONITORING THREAD FUNCTION =====
+// The monitor sleeps on g_monitorWake until the earliest pending deadline or until WakeMonitor() is called by
+// an event sink, a session start, a config reload or shutdown. With no rule in progress it has no deadline
+// and does not wake at all.
+void WakeMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(g_monitorMutex);
+        g_monitorWakePending = true;
+    }
+    g_monitorWake.notify_one();
+}
+
+void WaitForMonitorWake(std::optional<std::chrono::steady_clock::time_point> deadline) {
+    std::unique_lock<std::mutex> lock(g_monitorMutex);
+    auto woken = [] { return g_monitorWakePending || !g_monitoringActive || g_isShuttingDown.load(); };
+    if (deadline) {
+        g_monitorWake.wait_until(lock, *deadline, woken);
+    } else {
+        g_monitorWake.wait(lock, woken);
+    }
+    g_monitorWakePending = false;
+    ++g_monitorWakeups;
+}
+
+// Completion delays are timers on g_timerWheel; polls are due a check interval after the older of the two
+// checks.
+std::optional<std::chrono::steady_clock::time_point> NextMonitorDeadline() {
+    std::optional<std::chrono::steady_clock::time_point> timer = g_timerWheel.NextDeadline();
+    std::shared_ptr<const FixRuleTable> rules = GetFixRules();
+    if (!rules) {
+        return timer;
+    }
+    const auto interval = std::chrono::milliseconds(GetConfig()->monitoring.checkIntervalMs);
+    return NextMonitorDeadline(*rules->phases, rules->size(), CurrentSession(),
+                               (std::min)(g_lastQuestCheck, g_lastItemCheck), interval, timer);
+}
+
+void MonitoringThreadFunction() {
+    LogSystem("Monitoring thread started - Watching quest state and player inventory");
+    LogSystem("Monitoring on dual paths (Primary & Secondary)");
+    LogSystem("Primary: {}", g_logPaths.primary.string());
+    LogSystem("Secondary: {}", g_logPaths.secondary.string());
+    LogSystem("Waiting 5 seconds before starting quest monitoring");
+
+    g_monitoringStartTime = std::chrono::steady_clock::now();
+    g_initialDelayComplete = false;
+
+    g_timerWheel.Schedule(std::chrono::seconds(5), kTimerAnySession, [] {
+        g_initialDelayComplete = true;
+        LogSystem("5-second initial delay complete, starting quest monitoring");
+
+        // A loaded save raises no stage events for quests that are already running, so the first
+        // pass polls every rule once.
+        g_lastQuestCheck = {};
+        g_lastItemCheck = {};
+    });
+
+    while (g_monitoringActive && !g_isShuttingDown.load()) {
+        
+        if (g_isInGameTransition.load()) {
+            LogSystem<LogLevel::Trace>("Game transition detected - monitoring paused");
+            WaitForMonitorWake(std::nullopt);
+            continue;
+        }
+
+        if (std::size_t dropped = g_timerWheel.Advance(std::chrono::steady_clock::now(), CurrentSession())) {
+            LogSystem<LogLevel::Debug>("Dropped {} timer(s) armed before the current save was loaded", dropped);
+        }
+
+        if (!g_initialDelayComplete) {
+            WaitForMonitorWake(g_timerWheel.NextDeadline());
+            continue;
+        }
+        
+        g_monitorCycles++;
+        
+        ResolveFormIDs();
+        CheckQuestState();
+        CheckPlayerInventory();
+        
+        WaitForMonitorWake(NextMonitorDeadline());
+    }
+
+    LogSystem("Monitoring thread stopped");
+}
+
+void StartMonitoringThread() {
+    if (!g_monitoringActive) {
+        g_monitoringActive = true;
+        g_monitorCycles = 0;
+        g_monitorWakeups = 0;
+        g_initialDelayComplete = false;
+        
+        ResetFixRuleStates();
+        
+        g_lastQuestCheck = std::chrono::steady_clock::now();
+        g_lastItemCheck = std::chrono::steady_clock::now();
+        
+        g_monitorThread = std::thread(MonitoringThreadFunction);
+
+        LogSystem("MONITORING SYSTEM ACTIVATED");
+    }
+}
+
+void StopMonitoringThread() {
+    if (g_monitoringActive) {
+        auto stopStart = std::chrono::steady_clock::now();
+        auto runtime = std::chrono::duration<double, std::ratio<60>>(stopStart - g_monitoringStartTime).count();
+
+        g_monitoringActive = false;
+        WakeMonitor();
+        if (g_monitorThread.joinable()) {
+            g_monitorThread.join();
+        }
+
+        auto stopMs =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stopStart).count();
+        LogSystem("Monitoring thread stopped and joined in {} ms - {} wakeups ({:.1f}/min), {} cycles", stopMs,
+                  g_monitorWakeups.load(), runtime > 0.0 ? g_monitorWakeups.load() / runtime : 0.0, g_monitorCycles);
+    }
+}
+
+// Logs the monitor's wake rate since the previous call. Called at every session start, since the process
+// usually exits without StopMonitoringThread ever running.
+void LogMonitorWakeRate() {
+    static std::uint64_t lastWakeups = 0;
+    static auto lastSample = std::chrono::steady_clock::now();
+
+    auto now = std::chrono::steady_clock::now();
+    std::uint64_t wakeups = g_monitorWakeups.load(std::memory_order_relaxed);
+    auto minutes = std::chrono::duration<double, std::ratio<60>>(now - lastSample).count();
+    std::uint64_t delta = wakeups >= lastWakeups ? wakeups - lastWakeups : wakeups;
+    LogSystem("Monitor woke {} time(s) in the last {:.1f} min ({:.1f}/min)", delta, minutes,
+              minutes > 0.0 ? delta / minutes : 0.0);
+    lastWakeups = wakeups;
+    lastSample = now;
+}
+
+// ===== PLUGIN INITIALIZATION =====
+void SetupLog() {
+    auto logsFolder = SKSE::log::log_directory();
+    if (!logsFolder) {
+        SKSE::stl::report_and_fail("SKSE log_directory not provided, logs disabled.");
+        return;
+    }
+    auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
+    auto logFilePath = *logsFolder / std::format("{}.log", pluginName);
+    auto fileLoggerPtr = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true);
+    auto loggerPtr = std::make_shared<spdlog::logger>("log", std::move(fileLoggerPtr));
+    spdlog::set_default_logger(std::move(loggerPtr));
+    spdlog::set_level(spdlog::level::trace);
+    spdlog::flush_on(spdlog::level::info);
+}
+
+void InitializePlugin() {
+    try {
+        LoadConfiguration();
+
+        g_documentsPath = GetDocumentsPath();
+        g_logPaths = GetAllSKSELogsPaths();
+        AsyncLogWriter::GetSingleton().Start(g_logPaths, GetLogWriterSettings());
+
+        LogSystem("BWY-multi-Fix-NG Plugin - v6.2.2");
+        LogActions("BWY-multi-Fix-NG Actions Monitor - v6.2.2");
+        LogQuest("BWY-multi-Fix-NG Quest Monitor - v6.2.2");
+
+        const std::shared_ptr<const PluginConfig> configSnapshot = GetConfig();
+        const PluginConfig& config = *configSnapshot;
+        WriteDeferredLog(LogChannel::System, LogFormatId::Separator);
+        LogSystem("PLUGIN CONFIGURATION LOADED");
+        LogSystem("Quest Monitoring: {}", config.quest.enabled ? "Enabled" : "Disabled");
+        LogSystem("Quest EditorID: {}", config.quest.questEditorID);
+        LogSystem("Quest Plugin: {}", config.quest.questPlugin);
+        LogSystem("Trigger Stage: {}", config.quest.triggerStage);
+        LogSystem("Completion Stage: {}", config.quest.completionStage);
+        LogSystem("Item Monitoring: {}", config.item.enabled ? "Enabled" : "Disabled");
+        LogSystem("Item ID: {}", config.item.itemID);
+        LogSystem("Item Plugin: {}", config.item.itemPlugin);
+        LogSystem("Item Name: {}", config.item.itemName);
+        WriteDeferredLog(LogChannel::System, LogFormatId::Separator);
+
+        g_isInitialized = true;
+
+        StartMonitoringThread();
+
+    } catch (const std::exception& e) {
+        logger::error("CRITICAL ERROR in Initialize: {}", e.what());
+    }
+}
+
+void ShutdownPlugin() {
+    LogSystem("PLUGIN SHUTTING DOWN");
+    LogActions("PLUGIN SHUTTING DOWN");
+    LogQuest("PLUGIN SHUTTING DOWN");
+
+    g_isShuttingDown = true;
+
+    auto* eventSourceHolder = RE::ScriptEventSourceHolder::GetSingleton();
+    if (eventSourceHolder) {
+        eventSourceHolder->RemoveEventSink(&ContainerChangeEventSink::GetSingleton());
+        eventSourceHolder->RemoveEventSink(&QuestStageEventSink::GetSingleton());
+        LogSystem("Event sinks unregistered");
+    }
+
+    StopMonitoringThread();
+    ConfigWatcher::GetSingleton().Stop();
+
+    WriteDeferredLog(LogChannel::System, LogFormatId::Separator);
+    LogSystem("Plugin shutdown complete at: {}", GetCurrentTimeString());
+    LogSystem("{}", FormatLogPathStats("primary", AsyncLogWriter::GetSingleton().GetPrimaryStats()));
+    LogSystem("{}", FormatLogPathStats("secondary", AsyncLogWriter::GetSingleton().GetSecondaryStats()));
+    WriteDeferredLog(LogChannel::System, LogFormatId::Separator);
+    
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+    LogQuest("Plugin shutdown complete at: {}", GetCurrentTimeString());
+    WriteDeferredLog(LogChannel::Quest, LogFormatId::Separator);
+
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+    LogActions("Plugin shutdown complete at: {}", GetCurrentTimeString());
+    WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+
+    AsyncLogWriter::GetSingleton().Stop();
+}
+
+// ===== MODIFIED MAIN FUNCTION WITH IMPROVED DETECTION FOR WABBAJACK/MO2 =====
+void MessageListener(SKSE::MessagingInterface::Message* message) {
+    switch (message->type) {
+        case SKSE::MessagingInterface::kNewGame:
+        case SKSE::MessagingInterface::kPostLoadGame:
+            {
+                WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+                LogActions("SESSION START (New/Load) - Resetting Logic State safely");
+                
+                g_isInGameTransition = false;
+                g_isShuttingDown = false;
+                
+                ResetFixRuleStates();
+                LogMonitorWakeRate();
+                
+                // The initial delay runs once per process; a later load just polls every rule once.
+                g_lastQuestCheck = {};
+                g_lastItemCheck = {};
+                
+                LogActions("Logic reset complete.");
+                
+                if (!g_monitoringActive) {
+                    LogActions("Monitoring thread logic: Starting...");
+                    StartMonitoringThread();
+                } else {
+                    LogActions("Monitoring thread logic: Already active, continuing.");
+                    WakeMonitor();
+                }
+                
+                WriteDeferredLog(LogChannel::Actions, LogFormatId::Separator);
+            }
+            break;
+
+        case SKSE::MessagingInterface::kDataLoaded:
+            {
+                auto& eventProcessor = GameEventProcessor::GetSingleton();
+                RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessor);
+                
+                auto* eventSourceHolder = RE::ScriptEventSourceHolder::GetSingleton();
+                if (eventSourceHolder) {
+                    eventSourceHolder->AddEventSink(&ContainerChangeEventSink::GetSingleton());
+                    eventSourceHolder->AddEventSink(&QuestStageEventSink::GetSingleton());
+                    LogSystem("Container and Quest event sinks registered");
+                }
+                
+                if (!g_isInitialized) {
+                    LoadConfiguration();
+
+                    g_documentsPath = GetDocumentsPath();
+                    g_logPaths = GetAllSKSELogsPaths();
+                    AsyncLogWriter::GetSingleton().Start(g_logPaths, GetLogWriterSettings());
+                    
+                    LogSystem("BWY-multi-Fix-NG Plugin - v6.2.2 (DataLoaded)");
+                    g_isInitialized = true;
+                }
+                
+                if (auto* player = RE::PlayerCharacter::GetSingleton()) {
+                    g_playerFormID.store(player->GetFormID(), std::memory_order_relaxed);
+                }
+
+                LoadedPluginIndex::GetSingleton().Build();
+                ValidatePluginsInINI();
+                ResolveFormIDs();
+                ConfigWatcher::GetSingleton().Start(GetPluginINIPath());
+                
+                if (!g_monitoringActive) {
+                    StartMonitoringThread();
+                }
+
+                WriteDeferredLog(LogChannel::System, LogFormatId::Separator);
+                LogSystem("DATA LOADED - Plugin fully initialized");
+                if (std::shared_ptr<const FixRuleTable> rules = GetFixRules()) {
+                    for (std::uint32_t rule = 0; rule < rules->size(); ++rule) {
+                        LogSystem("[{}] Quest to monitor: {} (trigger stage {}, completion stage {})",
+                                  rules->names[rule], rules->questEditorIDs[rule], rules->triggerStages[rule],
+                                  rules->completionStages[rule]);
+                    }
+                }
+                WriteDeferredLog(LogChannel::System, LogFormatId::Separator);
+            }
+            break;
+
+        case SKSE::MessagingInterface::kPreLoadGame:
+            {
+                LogActions("Pre-load game detected - preparing for state reset");
+                g_isInGameTransition = true;
+                BeginSessionGeneration();
+            }
+            break;
+
+        case SKSE::MessagingInterface::kPostLoad:
+            {
+                LogSystem<LogLevel::Debug>("Post-load message received");
+            }
+            break;
+
+        case SKSE::MessagingInterface::kInputLoaded:
+            {
+                LogSystem<LogLevel::Debug>("Input loaded message received");
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ===== SKSE PLUGIN LOAD - TRUNCATE LOGS ON GAME START =====
+SKSEPluginLoad(const SKSE::LoadInterface* a_skse) {
+    SKSE::Init(a_skse);
+    SetupLog();
+
+    logger::info("BWY-multi-Fix-NG Plugin v6.2.2 - Starting");
+
+    auto logsFolder = SKSE::log::log_directory();
+    if (logsFolder) {
+        // Each live index describes offsets into its live log, so the two are always truncated together.
+        // Rotated segments from earlier sessions go too; otherwise the first rotation of this session
+        // would shift them into the retained window and queries would mix the sessions.
+        for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+            auto channel = static_cast<LogChannel>(i);
+            RemoveRotatedLogSegments(*logsFolder, channel);
+            std::ofstream(*logsFolder / GetLogFileName(channel), std::ios::trunc).close();
+            std::ofstream(GetLogIndexPath(*logsFolder, channel, 0), std::ios::trunc | std::ios::binary).close();
+            std::ofstream(GetBinaryLogPath(*logsFolder, channel, 0), std::ios::trunc | std::ios::binary).close();
+        }
+        logger::info("Custom log files truncated successfully");
+    }
+
+    SKSE::GetMessagingInterface()->RegisterListener(MessageListener);
+
+    logger::info("BWY-multi-Fix-NG Plugin loaded successfully");
+    logger::info("Monitoring quest: YW_Quest_MDF");
+    logger::info("Trigger stage: 21, Completion stage: 30");
+    logger::info("Target item: Lelyna's Remedy (625C7C from YurianaWench.esp)");
+
+    return true;
+}
+
+// ===== PLUGIN VERSION DECLARATION =====
+constinit auto SKSEPlugin_Version = []() {
+    SKSE::PluginVersionData v;
+    v.PluginVersion({6, 2, 2});
+    v.PluginName("BWY-multi-Fix-NG Quest Monitor");
+    v.AuthorName("John95AC");
+    v.UsesAddressLibrary();
+    v.UsesSigScanning();
+    v.CompatibleVersions({SKSE::RUNTIME_SSE_LATEST, SKSE::RUNTIME_LATEST_VR});
+
+    return v;
 }();
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "PluginCore.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+
+// The deferred records one quest stage event with an item pickup produces.
+std::vector<DeferredLogRecord> MakeStageEventRecords() {
+    const std::pair<LogFormatId, std::array<std::int64_t, kDeferredLogMaxArgs>> calls[] = {
+        {LogFormatId::Separator, {}},
+        {LogFormatId::QuestStageEventReceived, {}},
+        {LogFormatId::Separator, {}},
+        {LogFormatId::QuestStageChanged, {20, 21}},
+        {LogFormatId::NewStage, {21}},
+        {LogFormatId::TriggerStage, {21}},
+        {LogFormatId::Separator, {}},
+        {LogFormatId::ContainerItemAdded, {}},
+        {LogFormatId::Separator, {}},
+        {LogFormatId::ItemFormID, {0x0A625C7C}},
+        {LogFormatId::ItemCount, {1}},
+    };
+
+    std::vector<DeferredLogRecord> records;
+    std::int64_t timestampMs = 1'790'000'000'000;
+    std::uint32_t lineNumber = 2400;
+    for (const auto& [format, args] : calls) {
+        DeferredLogRecord record;
+        record.timestampMs = timestampMs;
+        record.format = format;
+        record.lineNumber = lineNumber;
+        record.args = args;
+        records.push_back(record);
+        timestampMs += 3;
+        lineNumber += 7;
+    }
+    return records;
+}
+
+// What the writer thread does per drained record in each mode, up to the
+// point the batch is handed to the file. bytes_per_record is what reaches disk.
+void RunBatch(benchmark::State& state, bool binaryDeferred) {
+    const std::vector<DeferredLogRecord> records = MakeStageEventRecords();
+    LogBatch batch;
+    batch.binaryDeferred = binaryDeferred;
+    std::size_t bytes = 0;
+    std::size_t appended = 0;
+
+    for (auto _ : state) {
+        for (const auto& record : records) {
+            batch.Append(LogChannel::Quest, LogRecordKind::Deferred, record.timestampMs,
+                         std::string_view(reinterpret_cast<const char*>(&record), sizeof(record)));
+        }
+        appended += records.size();
+        if (appended >= 1024) {
+            bytes += batch.text.size() + batch.binary.size();
+            batch.Clear();
+            appended = 0;
+        }
+        benchmark::ClobberMemory();
+    }
+    bytes += batch.text.size() + batch.binary.size();
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * records.size()));
+    state.counters["bytes_per_record"] =
+        static_cast<double>(bytes) / static_cast<double>(state.iterations() * records.size());
+}
+
+void BM_DeferredRecordsAsText(benchmark::State& state) {
+    RunBatch(state, false);
+}
+BENCHMARK(BM_DeferredRecordsAsText);
+
+void BM_DeferredRecordsAsBinary(benchmark::State& state) {
+    RunBatch(state, true);
+}
+BENCHMARK(BM_DeferredRecordsAsBinary);
+
+// The offline half: bwy_logtool decode renders the same lines the text mode
+// would have written.
+void BM_DecodeAndRenderBinary(benchmark::State& state) {
+    const std::vector<DeferredLogRecord> records = MakeStageEventRecords();
+    BinaryLogEncoder encoder;
+    std::string data;
+    for (int i = 0; i < 100; ++i) {
+        for (const auto& record : records) {
+            encoder.Append(data, LogChannel::Quest, record);
+        }
+    }
+
+    char line[kLogRecordTextSize];
+    for (auto _ : state) {
+        DecodeBinaryLog(data, [&line](LogChannel channel, const DeferredLogRecord& record) {
+            benchmark::DoNotOptimize(RenderDeferredLogLine(line, channel, record));
+        });
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * records.size() * 100));
+}
+BENCHMARK(BM_DecodeAndRenderBinary);
+
+}  // namespace
@@ -0,0 +1,220 @@
+#include "log_corpus.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct DecodedRecord {
+    LogChannel channel;
+    DeferredLogRecord record;
+};
+
+std::vector<DecodedRecord> Decode(std::string_view data, bool* complete = nullptr) {
+    std::vector<DecodedRecord> records;
+    bool ok = DecodeBinaryLog(data, [&records](LogChannel channel, const DeferredLogRecord& record) {
+        records.push_back({channel, record});
+    });
+    if (complete) {
+        *complete = ok;
+    }
+    return records;
+}
+
+std::string RenderLine(LogChannel channel, const DeferredLogRecord& record) {
+    char line[kLogRecordTextSize];
+    return std::string(line, RenderDeferredLogLine(line, channel, record));
+}
+
+// Arguments past a format's placeholders are never rendered, so they are not
+// stored either; the round trip keeps everything else exactly.
+std::vector<DeferredLogRecord> MakeRecords(std::size_t count, std::uint32_t seed) {
+    std::mt19937_64 random(seed);
+    const std::int64_t samples[] = {0, 1, -1, 21, 0x0001A2B3, 0xFF625C7C, std::numeric_limits<std::int64_t>::min(),
+                                    std::numeric_limits<std::int64_t>::max()};
+
+    std::vector<DeferredLogRecord> records(count);
+    std::int64_t timestampMs = 1'790'000'000'000;
+    for (auto& record : records) {
+        timestampMs += static_cast<std::int64_t>(random() % 5000) - 100;
+        record.timestampMs = timestampMs;
+        record.format = static_cast<LogFormatId>(random() % kLogFormats.size());
+        record.level = static_cast<LogLevel>(random() % 5);
+        record.lineNumber = static_cast<std::uint32_t>(random() % 5000);
+        std::size_t args = kLogFormatArgCounts[static_cast<std::size_t>(record.format)];
+        for (std::size_t i = 0; i < args; ++i) {
+            record.args[i] = samples[random() % std::size(samples)];
+        }
+    }
+    return records;
+}
+
+void ExpectSameRecord(const DeferredLogRecord& actual, const DeferredLogRecord& expected) {
+    EXPECT_EQ(actual.timestampMs, expected.timestampMs);
+    EXPECT_EQ(actual.format, expected.format);
+    EXPECT_EQ(actual.level, expected.level);
+    EXPECT_EQ(actual.lineNumber, expected.lineNumber);
+    EXPECT_EQ(actual.args, expected.args);
+}
+
+TEST(BinaryLogTest, CountsPlaceholdersPerFormat) {
+    EXPECT_EQ(kLogFormatArgCounts[static_cast<std::size_t>(LogFormatId::Separator)], 0);
+    EXPECT_EQ(kLogFormatArgCounts[static_cast<std::size_t>(LogFormatId::QuestStageChanged)], 2);
+    EXPECT_EQ(kLogFormatArgCounts[static_cast<std::size_t>(LogFormatId::ItemFormID)], 1);
+}
+
+TEST(BinaryLogTest, ZigZagRoundTripsExtremes) {
+    for (std::int64_t value : {std::int64_t{0}, std::int64_t{-1}, std::int64_t{1},
+                               std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()}) {
+        EXPECT_EQ(ZigZagDecode(ZigZagEncode(value)), value);
+    }
+    EXPECT_EQ(ZigZagEncode(-1), 1u);
+    EXPECT_EQ(ZigZagEncode(1), 2u);
+}
+
+TEST(BinaryLogTest, RoundTripsEveryFieldAndRendersTheSameLine) {
+    std::vector<DeferredLogRecord> records = MakeRecords(5000, 7);
+    BinaryLogEncoder encoder;
+    std::string data;
+    for (const auto& record : records) {
+        encoder.Append(data, LogChannel::Quest, record);
+    }
+
+    bool complete = false;
+    std::vector<DecodedRecord> decoded = Decode(data, &complete);
+    EXPECT_TRUE(complete);
+    ASSERT_EQ(decoded.size(), records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(decoded[i].channel, LogChannel::Quest);
+        ExpectSameRecord(decoded[i].record, records[i]);
+        EXPECT_EQ(RenderLine(decoded[i].channel, decoded[i].record), RenderLine(LogChannel::Quest, records[i]));
+    }
+}
+
+// A reset writes a new session header, which restarts the timestamp deltas
+// and may name another channel.
+TEST(BinaryLogTest, DecodesConsecutiveSessions) {
+    std::vector<DeferredLogRecord> first = MakeRecords(10, 1);
+    std::vector<DeferredLogRecord> second = MakeRecords(10, 2);
+
+    BinaryLogEncoder encoder;
+    std::string data;
+    for (const auto& record : first) {
+        encoder.Append(data, LogChannel::Actions, record);
+    }
+    encoder.Reset();
+    for (const auto& record : second) {
+        encoder.Append(data, LogChannel::System, record);
+    }
+
+    std::vector<DecodedRecord> decoded = Decode(data);
+    ASSERT_EQ(decoded.size(), 20u);
+    for (std::size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(decoded[i].channel, LogChannel::Actions);
+        ExpectSameRecord(decoded[i].record, first[i]);
+        EXPECT_EQ(decoded[10 + i].channel, LogChannel::System);
+        ExpectSameRecord(decoded[10 + i].record, second[i]);
+    }
+}
+
+TEST(BinaryLogTest, StopsAtACutOffRecord) {
+    std::vector<DeferredLogRecord> records = MakeRecords(100, 3);
+    BinaryLogEncoder encoder;
+    std::string data;
+    for (const auto& record : records) {
+        encoder.Append(data, LogChannel::Quest, record);
+    }
+    data.resize(data.size() - 1);
+
+    bool complete = true;
+    std::vector<DecodedRecord> decoded = Decode(data, &complete);
+    EXPECT_FALSE(complete);
+    EXPECT_EQ(decoded.size(), records.size() - 1);
+}
+
+TEST(BinaryLogTest, RejectsOtherFiles) {
+    bool complete = true;
+    EXPECT_TRUE(Decode("[2026-10-16 12:00:00.000] [log] [info] [plugin.cpp:1] text\n", &complete).empty());
+    EXPECT_FALSE(complete);
+
+    BinaryLogEncoder encoder;
+    std::string data;
+    encoder.Append(data, LogChannel::Quest, MakeRecords(1, 4).front());
+    data[1] ^= 0x20;
+    EXPECT_TRUE(Decode(data, &complete).empty());
+    EXPECT_FALSE(complete);
+
+    EXPECT_TRUE(Decode("", &complete).empty());
+    EXPECT_TRUE(complete);
+}
+
+// A file written before the newest formats were added names a shorter table;
+// its records still decode, and only IDs past that table are rejected.
+TEST(BinaryLogTest, AcceptsSessionsWithAnOlderFormatTable) {
+    constexpr std::size_t kFormatCountByte = 7;
+    const std::size_t olderCount = kLogFormats.size() - 2;
+
+    BinaryLogEncoder encoder;
+    std::string data;
+    DeferredLogRecord stage;
+    stage.timestampMs = 5000;
+    stage.format = LogFormatId::Stage;
+    stage.args[0] = 21;
+    encoder.Append(data, LogChannel::Quest, stage);
+    data[kFormatCountByte] = static_cast<char>(olderCount);
+
+    bool complete = false;
+    std::vector<DecodedRecord> decoded = Decode(data, &complete);
+    EXPECT_TRUE(complete);
+    ASSERT_EQ(decoded.size(), 1u);
+    ExpectSameRecord(decoded[0].record, stage);
+
+    DeferredLogRecord newer;
+    newer.timestampMs = 5001;
+    newer.format = static_cast<LogFormatId>(olderCount);
+    encoder.Append(data, LogChannel::Quest, newer);
+    decoded = Decode(data, &complete);
+    EXPECT_FALSE(complete);
+    EXPECT_EQ(decoded.size(), 1u);
+
+    data[kFormatCountByte] = static_cast<char>(kLogFormats.size() + 1);
+    EXPECT_TRUE(Decode(data, &complete).empty());
+    EXPECT_FALSE(complete);
+}
+
+// In binary mode the batch keeps deferred records out of the text, while text
+// records still go to the .log file. Later batches continue the session, so
+// the file is the concatenation of every batch.
+TEST(BinaryLogTest, BatchRoutesDeferredRecordsToBinary) {
+    LogBatch batch;
+    batch.binaryDeferred = true;
+    AppendTextLine(batch, LogChannel::Quest, 1000, "plain text");
+    AppendDeferredLine(batch, LogChannel::Quest, 1001, LogFormatId::Stage, 21);
+    AppendDeferredLine(batch, LogChannel::Quest, 1002, LogFormatId::FormID, 0x625C7C);
+
+    EXPECT_EQ(batch.lines, 3u) << "binary records count toward segment rotation";
+    EXPECT_TRUE(batch.text.ends_with("plain text\n"));
+
+    std::vector<DecodedRecord> decoded = Decode(batch.binary);
+    ASSERT_EQ(decoded.size(), 2u);
+    EXPECT_TRUE(RenderLine(decoded[0].channel, decoded[0].record).ends_with("Stage: 21"));
+    EXPECT_TRUE(RenderLine(decoded[1].channel, decoded[1].record).ends_with("FormID: 0x625C7C"));
+
+    std::string file = batch.binary;
+    batch.Clear();
+    EXPECT_TRUE(batch.binary.empty());
+    AppendDeferredLine(batch, LogChannel::Quest, 1003, LogFormatId::Separator);
+    file += batch.binary;
+
+    bool complete = false;
+    decoded = Decode(file, &complete);
+    EXPECT_TRUE(complete);
+    ASSERT_EQ(decoded.size(), 3u);
+    EXPECT_EQ(decoded[2].record.timestampMs, 1003);
+}
+
+}  // namespace
@@ -0,0 +1,160 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class ConfigReloadTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("bwy_reload_" + std::to_string(getpid()) + "_" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::create_directories(directory_);
+        iniPath_ = directory_ / "BWY-multi-Fix-NG.ini";
+    }
+    void TearDown() override { std::filesystem::remove_all(directory_); }
+
+    // Writes a document whose stages and interval are all derived from
+    // version, and stamps it with a write time unique to that version.
+    void WriteVersion(int version) {
+        std::ofstream(iniPath_, std::ios::trunc)
+            << "[Quest]\nTriggerStage=" << version << "\nCompletionStage=" << version + 1000
+            << "\n[Monitoring]\nCheckIntervalMs=" << version + 2000 << "\n";
+        std::filesystem::last_write_time(iniPath_, kBaseWriteTime + std::chrono::seconds(version));
+    }
+
+    static inline const std::filesystem::file_time_type kBaseWriteTime =
+        std::filesystem::file_time_type::clock::now() - std::chrono::hours(24);
+
+    std::filesystem::path directory_;
+    std::filesystem::path iniPath_;
+};
+
+TEST_F(ConfigReloadTest, FilterReportsOnlyNewWritesOfAnExistingFile) {
+    WriteVersion(1);
+    FileChangeFilter filter(iniPath_);
+    EXPECT_FALSE(filter.Changed());
+
+    std::ofstream(directory_ / "neighbour.ini") << "x";
+    EXPECT_FALSE(filter.Changed());
+
+    WriteVersion(2);
+    EXPECT_TRUE(filter.Changed());
+    EXPECT_FALSE(filter.Changed());
+
+    std::filesystem::remove(iniPath_);
+    EXPECT_FALSE(filter.Changed());
+    WriteVersion(3);
+    EXPECT_TRUE(filter.Changed());
+}
+
+TEST_F(ConfigReloadTest, ReadsFreshConfigurationOrNothing) {
+    EXPECT_EQ(ReadConfigurationFile(iniPath_), nullptr);
+
+    WriteVersion(7);
+    auto config = ReadConfigurationFile(iniPath_);
+    ASSERT_NE(config, nullptr);
+    EXPECT_EQ(config->quest.triggerStage, 7);
+    EXPECT_EQ(config->quest.completionStage, 1007);
+    EXPECT_EQ(config->monitoring.checkIntervalMs, 2007);
+    EXPECT_EQ(config->quest.questEditorID, PluginConfig().quest.questEditorID);
+}
+
+TEST_F(ConfigReloadTest, PublishedSnapshotsOutliveLaterReloads) {
+    auto defaults = std::make_shared<const PluginConfig>();
+    SnapshotPublisher<PluginConfig> snapshots(defaults);
+    EXPECT_EQ(snapshots.Get(), defaults);
+
+    WriteVersion(1);
+    std::shared_ptr<const PluginConfig> first = snapshots.Publish(ReadConfigurationFile(iniPath_));
+    WriteVersion(2);
+    snapshots.Publish(ReadConfigurationFile(iniPath_));
+
+    EXPECT_EQ(snapshots.Get()->quest.triggerStage, 2);
+    EXPECT_EQ(first->quest.triggerStage, 1);
+    EXPECT_EQ(snapshots.PublishedCount(), 2u);
+}
+
+// Reloading forever must not grow memory forever: a retired snapshot is freed as soon as no reader holds it.
+TEST_F(ConfigReloadTest, FreesRetiredSnapshotsOnceReadersLetGo) {
+    SnapshotPublisher<PluginConfig> snapshots;
+    EXPECT_EQ(snapshots.Get(), nullptr);
+
+    std::weak_ptr<const PluginConfig> first = snapshots.Publish(std::make_shared<const PluginConfig>());
+    std::shared_ptr<const PluginConfig> held = snapshots.Publish(std::make_shared<const PluginConfig>());
+    EXPECT_TRUE(first.expired());
+
+    std::weak_ptr<const PluginConfig> second = held;
+    for (int i = 0; i < 100; ++i) {
+        snapshots.Publish(std::make_shared<const PluginConfig>());
+    }
+    EXPECT_FALSE(second.expired());
+    held.reset();
+    EXPECT_TRUE(second.expired());
+    EXPECT_EQ(snapshots.Get().use_count(), 2);  // the publisher's and this temporary's
+}
+
+// The watcher thread reloads while event sinks and the monitor keep reading:
+// every snapshot a reader sees must be one complete document, and versions
+// only move forward.
+TEST_F(ConfigReloadTest, ReadersNeverSeeATornOrOlderSnapshot) {
+    const int kReloads = 500;
+
+    WriteVersion(0);
+    SnapshotPublisher<PluginConfig> snapshots(std::make_shared<const PluginConfig>());
+    snapshots.Publish(ReadConfigurationFile(iniPath_));
+
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            int lastVersion = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                std::shared_ptr<const PluginConfig> snapshot = snapshots.Get();
+                const PluginConfig& config = *snapshot;
+                int version = config.quest.triggerStage;
+                if (config.quest.completionStage != version + 1000 ||
+                    config.monitoring.checkIntervalMs != version + 2000 || version < lastVersion) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                lastVersion = version;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    FileChangeFilter filter(iniPath_);
+    int reloaded = 0;
+    for (int version = 1; version <= kReloads; ++version) {
+        WriteVersion(version);
+        if (filter.Changed()) {
+            if (auto config = ReadConfigurationFile(iniPath_)) {
+                snapshots.Publish(std::move(config));
+                ++reloaded;
+            }
+        }
+    }
+
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(reloaded, kReloads);
+    EXPECT_EQ(snapshots.Get()->quest.triggerStage, kReloads);
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_GT(reads.load(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,146 @@
+// Stress harness for the event sink filters: millions of synthetic quest stage and container change events,
+// shaped like a busy game where almost nothing concerns the player's watched quests and items, pushed through
+// the same first checks as QuestStageEventSink and ContainerChangeEventSink. The former quest filter (form
+// lookup, editor ID copy, string compare) runs on the same stream for comparison. Pass --quick for a short
+// run or --events N.
+
+#include "PluginCore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kPlayerFormID = 0x14;
+constexpr std::uint32_t kSession = 3;
+constexpr std::uint32_t kRuleCount = 64;
+constexpr std::size_t kStreamLength = 1 << 16;
+
+struct ContainerEvent {
+    std::uint32_t oldContainer;
+    std::uint32_t newContainer;
+    std::uint32_t baseObj;
+};
+
+struct Rules {
+    std::vector<std::uint32_t> questFormIDs;
+    std::vector<std::string> questEditorIDs;
+    FormIDIndex rulesByQuest;
+    FormIDIndex rulesByItem;
+    FixRulePhaseWords phases{kRuleCount};
+    std::vector<std::uint32_t> itemFormIDs;
+};
+
+// Every quest in a large load order, as the former filter looked them up by FormID.
+struct FakeFormTable {
+    std::unordered_map<std::uint32_t, std::string> editorIDs;
+};
+
+template <class Fn>
+double MeasureNanosPerEvent(std::size_t events, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           static_cast<double>(events);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t events = 20000000;
+    if (argc > 1 && std::strcmp(argv[1], "--quick") == 0) {
+        events = 500000;
+    } else if (argc > 2 && std::strcmp(argv[1], "--events") == 0) {
+        events = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    std::mt19937 random(1234);
+    Rules rules;
+    FakeFormTable forms;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> questEntries;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> itemEntries;
+    for (std::uint32_t rule = 0; rule < kRuleCount; ++rule) {
+        rules.questFormIDs.push_back(0x0A000000u | (0x100 + rule));
+        rules.questEditorIDs.push_back("YW_Quest_Fix_" + std::to_string(rule));
+        rules.itemFormIDs.push_back(0x0A000000u | (0x8000 + rule));
+        questEntries.emplace_back(rules.questFormIDs.back(), rule);
+        itemEntries.emplace_back(rules.itemFormIDs.back(), rule);
+        rules.phases.Store(rule, rule % 2 ? FixRulePhase::Active : FixRulePhase::Done, kSession);
+    }
+    rules.rulesByQuest.Build(questEntries);
+    rules.rulesByItem.Build(itemEntries);
+    for (std::uint32_t quest = 0; quest < 4000; ++quest) {
+        forms.editorIDs.emplace(0x01000000u | quest, "VanillaQuestWithALongEditorID" + std::to_string(quest));
+    }
+    for (std::uint32_t rule = 0; rule < kRuleCount; ++rule) {
+        forms.editorIDs.emplace(rules.questFormIDs[rule], rules.questEditorIDs[rule]);
+    }
+
+    // 1 in 200 quest events belongs to a watched quest; 1 in 50 container changes involves the player and
+    // 1 in 10 of those moves a watched item.
+    std::vector<std::uint32_t> questStream(kStreamLength);
+    std::vector<ContainerEvent> containerStream(kStreamLength);
+    for (std::size_t i = 0; i < kStreamLength; ++i) {
+        questStream[i] = random() % 200 == 0 ? rules.questFormIDs[random() % kRuleCount]
+                                             : 0x01000000u | static_cast<std::uint32_t>(random() % 4000);
+        ContainerEvent& event = containerStream[i];
+        event.oldContainer = 0x00010000u + random() % 5000;
+        event.newContainer = 0x00010000u + random() % 5000;
+        event.baseObj = 0x00020000u + random() % 20000;
+        if (random() % 50 == 0) {
+            (random() % 2 ? event.newContainer : event.oldContainer) = kPlayerFormID;
+            if (random() % 10 == 0) {
+                event.baseObj = rules.itemFormIDs[random() % kRuleCount];
+            }
+        }
+    }
+
+    std::size_t passed = 0;
+    double questIndexed = MeasureNanosPerEvent(events, [&] {
+        for (std::size_t i = 0; i < events; ++i) {
+            for (std::uint32_t rule : rules.rulesByQuest.Find(questStream[i & (kStreamLength - 1)])) {
+                passed += rules.phases.Load(rule, kSession) != FixRulePhase::Done;
+            }
+        }
+    });
+    std::size_t questIndexedPassed = passed;
+
+    passed = 0;
+    const std::string& watchedEditorID = rules.questEditorIDs[1];
+    double questByEditorID = MeasureNanosPerEvent(events, [&] {
+        for (std::size_t i = 0; i < events; ++i) {
+            auto form = forms.editorIDs.find(questStream[i & (kStreamLength - 1)]);
+            if (form == forms.editorIDs.end()) {
+                continue;
+            }
+            std::string questEditorID = form->second;
+            passed += questEditorID == watchedEditorID;
+        }
+    });
+
+    std::size_t containerPassed = 0;
+    double container = MeasureNanosPerEvent(events, [&] {
+        for (std::size_t i = 0; i < events; ++i) {
+            const ContainerEvent& event = containerStream[i & (kStreamLength - 1)];
+            if (!IsPlayerInventoryChange(event.oldContainer, event.newContainer, kPlayerFormID)) {
+                continue;
+            }
+            containerPassed += !rules.rulesByItem.Find(event.baseObj).empty();
+        }
+    });
+
+    std::printf("%zu events per filter, %u rules\n", events, kRuleCount);
+    std::printf("%-34s %8.2f ns/event  %zu passed\n", "quest stage, FormID index", questIndexed, questIndexedPassed);
+    std::printf("%-34s %8.2f ns/event  %zu passed (one rule only)\n", "quest stage, editor ID compare",
+                questByEditorID, passed);
+    std::printf("%-34s %8.2f ns/event  %zu passed\n", "container change, player + index", container,
+                containerPassed);
+
+    return questIndexedPassed > 0 && containerPassed > 0 ? 0 : 1;
+}
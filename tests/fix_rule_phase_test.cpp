@@ -0,0 +1,160 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr FixRulePhase kChain[] = {FixRulePhase::Idle,         FixRulePhase::Active,     FixRulePhase::Triggered,
+                                   FixRulePhase::ItemDetected, FixRulePhase::Completing, FixRulePhase::Done};
+constexpr std::size_t kSteps = std::size(kChain) - 1;
+
+TEST(FixRulePhaseWordsTest, TransitionsOnlyFromTheExpectedPhase) {
+    FixRulePhaseWords phases(2);
+    EXPECT_EQ(phases.Load(0, 1), FixRulePhase::Idle);
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Active, FixRulePhase::Triggered, 1));
+    EXPECT_TRUE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 1));
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 1));
+    EXPECT_EQ(phases.Load(0, 1), FixRulePhase::Active);
+    EXPECT_EQ(phases.Load(1, 1), FixRulePhase::Idle);
+}
+
+TEST(FixRulePhaseWordsTest, ANewSessionReadsEveryRuleAsIdle) {
+    FixRulePhaseWords phases(1);
+    phases.Store(0, FixRulePhase::Completing, 7);
+    EXPECT_EQ(phases.Load(0, 7), FixRulePhase::Completing);
+    EXPECT_EQ(phases.Load(0, 8), FixRulePhase::Idle);
+
+    // The completion timer from session 7 fires after session 8 began: it must not move the rule.
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Completing, FixRulePhase::Done, 8));
+    EXPECT_TRUE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 8));
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Completing, FixRulePhase::Done, 7));
+    EXPECT_EQ(phases.Load(0, 8), FixRulePhase::Active);
+
+    // Session 8's word reads as Idle to session 7, yet a late Idle -> Active from 7 must not replace it.
+    EXPECT_EQ(phases.Load(0, 7), FixRulePhase::Idle);
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 7));
+    EXPECT_EQ(phases.Load(0, 8), FixRulePhase::Active);
+}
+
+TEST(FixRulePhaseWordsTest, SessionCounterWrapKeepsOrdering) {
+    FixRulePhaseWords phases(1);
+    phases.Store(0, FixRulePhase::Active, 0xFFFFFF);
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 0xFFFFFE));
+    EXPECT_TRUE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 0x1000001));
+    EXPECT_FALSE(phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, 0xFFFFFF));
+}
+
+// Threads race every transition of every rule while a stale-session thread tries the same transitions with
+// the previous generation. Each session is reset only by bumping the generation. Every transition must be
+// won exactly once per rule and session, and never by the stale thread.
+TEST(FixRulePhaseWordsTest, ConcurrentTransitionsAreWonExactlyOnce) {
+    constexpr std::uint32_t kRules = 64;
+    constexpr std::uint32_t kSessions = 100;
+    constexpr int kThreads = 6;
+
+    FixRulePhaseWords phases(kRules);
+    std::vector<std::atomic<int>> wins(kRules * kSteps);
+    std::atomic<int> staleWins{0};
+
+    for (std::uint32_t session = 1; session <= kSessions; ++session) {
+        for (auto& count : wins) {
+            count.store(0, std::memory_order_relaxed);
+        }
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<std::uint32_t> order(kRules);
+                for (std::uint32_t rule = 0; rule < kRules; ++rule) {
+                    order[rule] = rule;
+                }
+                std::shuffle(order.begin(), order.end(), std::mt19937(session * 31 + t));
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                for (std::uint32_t rule : order) {
+                    for (std::size_t step = 0; step < kSteps; ++step) {
+                        if (phases.Transition(rule, kChain[step], kChain[step + 1], session)) {
+                            wins[rule * kSteps + step].fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {
+            }
+            for (std::uint32_t rule = 0; rule < kRules; ++rule) {
+                for (std::size_t step = 0; step < kSteps; ++step) {
+                    if (phases.Transition(rule, kChain[step], kChain[step + 1], session - 1)) {
+                        staleWins.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+
+        go.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (std::uint32_t rule = 0; rule < kRules; ++rule) {
+            ASSERT_EQ(phases.Load(rule, session), FixRulePhase::Done) << session << " " << rule;
+            ASSERT_EQ(phases.Load(rule, session + 1), FixRulePhase::Idle);
+            for (std::size_t step = 0; step < kSteps; ++step) {
+                ASSERT_EQ(wins[rule * kSteps + step].load(), 1) << session << " " << rule << " " << step;
+            }
+        }
+    }
+    EXPECT_EQ(staleWins.load(), 0);
+}
+
+// A quest toggling between running and stopped (Active <-> Idle) while event sinks fire duplicate triggers:
+// a rule is triggered at most once per session, and only out of Active.
+TEST(FixRulePhaseWordsTest, DuplicateTriggersNeverWinTwice) {
+    constexpr std::uint32_t kSession = 5;
+    constexpr int kTriggerThreads = 4;
+    FixRulePhaseWords phases(1);
+    std::atomic<int> triggers{0};
+    std::atomic<bool> stop{false};
+
+    std::thread toggler([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, kSession);
+            phases.Transition(0, FixRulePhase::Active, FixRulePhase::Idle, kSession);
+        }
+    });
+    std::vector<std::thread> sinks;
+    for (int t = 0; t < kTriggerThreads; ++t) {
+        sinks.emplace_back([&] {
+            for (int i = 0; i < 20000 && triggers.load() == 0; ++i) {
+                if (phases.Transition(0, FixRulePhase::Active, FixRulePhase::Triggered, kSession)) {
+                    triggers.fetch_add(1);
+                }
+            }
+            for (int i = 0; i < 20000; ++i) {
+                if (phases.Transition(0, FixRulePhase::Active, FixRulePhase::Triggered, kSession)) {
+                    triggers.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& sink : sinks) {
+        sink.join();
+    }
+    stop.store(true);
+    toggler.join();
+
+    EXPECT_LE(triggers.load(), 1);
+    if (triggers.load() == 1) {
+        EXPECT_EQ(phases.Load(0, kSession), FixRulePhase::Triggered);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,122 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Maps a recorder file the way MapFlightRecorderFile does on Windows: shared,
+// so the reader sees the records through the file while the mapping is live.
+class MappedRecorderFile {
+public:
+    explicit MappedRecorderFile(const std::filesystem::path& path) {
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0 && ftruncate(fd, kFlightRecorderFileSize) == 0) {
+            void* view = mmap(nullptr, kFlightRecorderFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            view_ = view == MAP_FAILED ? nullptr : view;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    ~MappedRecorderFile() {
+        if (view_) {
+            munmap(view_, kFlightRecorderFileSize);
+        }
+    }
+    MappedRecorderFile(const MappedRecorderFile&) = delete;
+    MappedRecorderFile& operator=(const MappedRecorderFile&) = delete;
+
+    void* View() const { return view_; }
+
+private:
+    void* view_ = nullptr;
+};
+
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("bwy_flight_" + std::to_string(getpid()) + "_" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::create_directories(directory_);
+        path_ = GetFlightRecorderPath(directory_, LogChannel::Quest);
+    }
+    void TearDown() override { std::filesystem::remove_all(directory_); }
+
+    std::filesystem::path directory_;
+    std::filesystem::path path_;
+};
+
+TEST_F(FlightRecorderTest, UnflushedRecordsAreReportedAsCrashTail) {
+    MappedRecorderFile file(path_);
+    ASSERT_NE(file.View(), nullptr);
+    FlightRecorder recorder;
+    recorder.Attach(file.View());
+
+    recorder.Record(LogRecordKind::Text, "first line");
+    DeferredLogRecord record;
+    record.timestampMs = 1700000000123;
+    record.format = LogFormatId::QuestStageChanged;
+    record.lineNumber = 42;
+    record.args = {10, 20, 0, 0};
+    recorder.Record(LogRecordKind::Deferred,
+                    std::string_view(reinterpret_cast<const char*>(&record), sizeof(record)));
+
+    auto tail = FlightRecorder::ReadCrashTail(path_, LogChannel::Quest);
+    ASSERT_EQ(tail.size(), 2u);
+    EXPECT_EQ(tail[0], "first line");
+    EXPECT_TRUE(tail[1].ends_with("[quest] [info] [plugin.cpp:42] Quest stage changed: 10 -> 20")) << tail[1];
+}
+
+TEST_F(FlightRecorderTest, FlushedSessionLeavesNoCrashTail) {
+    MappedRecorderFile file(path_);
+    ASSERT_NE(file.View(), nullptr);
+    FlightRecorder recorder;
+    recorder.Attach(file.View());
+
+    recorder.Record(LogRecordKind::Text, "persisted");
+    recorder.MarkPersisted(recorder.Sequence());
+    EXPECT_TRUE(FlightRecorder::ReadCrashTail(path_, LogChannel::Quest).empty());
+    EXPECT_EQ(FlightRecorder::ReadTail(path_, LogChannel::Quest).size(), 1u);
+
+    recorder.Record(LogRecordKind::Text, "not yet persisted");
+    EXPECT_EQ(FlightRecorder::ReadCrashTail(path_, LogChannel::Quest).size(), 2u);
+
+    recorder.MarkClean();
+    EXPECT_TRUE(FlightRecorder::ReadCrashTail(path_, LogChannel::Quest).empty());
+}
+
+TEST_F(FlightRecorderTest, KeepsNewestRecordsInOrderAfterWrapping) {
+    MappedRecorderFile file(path_);
+    ASSERT_NE(file.View(), nullptr);
+    FlightRecorder recorder;
+    recorder.Attach(file.View());
+
+    const std::size_t total = kFlightRecorderSlotCount * 2 + 17;
+    for (std::size_t i = 0; i < total; ++i) {
+        recorder.Record(LogRecordKind::Text, "line " + std::to_string(i));
+    }
+
+    auto tail = FlightRecorder::ReadCrashTail(path_, LogChannel::Quest);
+    ASSERT_EQ(tail.size(), kFlightRecorderSlotCount);
+    for (std::size_t i = 0; i < tail.size(); ++i) {
+        ASSERT_EQ(tail[i], "line " + std::to_string(total - kFlightRecorderSlotCount + i));
+    }
+}
+
+TEST_F(FlightRecorderTest, RejectsMissingAndForeignFiles) {
+    EXPECT_FALSE(FlightRecorder::ReadHeader(path_));
+
+    std::ofstream(path_, std::ios::binary) << std::string(kFlightRecorderFileSize, 'x');
+    EXPECT_FALSE(FlightRecorder::ReadHeader(path_));
+    EXPECT_TRUE(FlightRecorder::ReadCrashTail(path_, LogChannel::Quest).empty());
+}
+
+}  // namespace
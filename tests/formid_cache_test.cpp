@@ -0,0 +1,163 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct FakePlugin {
+    std::string name;
+    std::uint8_t compileIndex;
+    std::uint16_t smallFileCompileIndex;
+};
+
+// The same fold-and-hash walk LoadedPluginIndex::Build does over the data handler's files.
+std::uint64_t Fingerprint(const std::vector<FakePlugin>& loadOrder) {
+    std::uint64_t fingerprint = kLoadOrderFingerprintSeed;
+    for (const auto& plugin : loadOrder) {
+        fingerprint = HashLoadOrderEntry(fingerprint, FoldPluginName(plugin.name), plugin.compileIndex,
+                                         plugin.smallFileCompileIndex);
+    }
+    return fingerprint;
+}
+
+std::vector<FakePlugin> BaseLoadOrder() {
+    return {{"Skyrim.esm", 0x00, 0},
+            {"Update.esm", 0x01, 0},
+            {"Dawnguard.esm", 0x02, 0},
+            {"BWY.esp", 0x0A, 0},
+            {"SmallFix.esl", 0xFE, 0x003}};
+}
+
+class FormIDCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = std::filesystem::temp_directory_path() /
+                ("bwy_formcache_" + std::to_string(getpid()) + "_" +
+                 ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove(path_);
+    }
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    void SaveEntries(std::uint64_t fingerprint) {
+        FormIDCache cache;
+        EXPECT_EQ(cache.Load(path_, fingerprint), FormIDCacheLoad::Missing);
+        cache.Store(FormIDCache::QuestKey("YW_Quest"), 0x0A001234);
+        cache.Store(FormIDCache::ItemKey("BWY.esp", "XX00ABCD"), 0x0A00ABCD);
+        ASSERT_TRUE(cache.Save());
+    }
+
+    std::filesystem::path path_;
+};
+
+TEST(LoadOrderFingerprintTest, ChangesWithEveryLoadOrderEdit) {
+    const std::uint64_t base = Fingerprint(BaseLoadOrder());
+
+    auto renamedCase = BaseLoadOrder();
+    renamedCase[3].name = "bwy.ESP";
+    EXPECT_EQ(Fingerprint(renamedCase), base);
+
+    auto added = BaseLoadOrder();
+    added.push_back({"NewMod.esp", 0x0B, 0});
+    EXPECT_NE(Fingerprint(added), base);
+
+    auto removed = BaseLoadOrder();
+    removed.erase(removed.begin() + 2);
+    EXPECT_NE(Fingerprint(removed), base);
+
+    auto moved = BaseLoadOrder();
+    moved[3].compileIndex = 0x0C;
+    EXPECT_NE(Fingerprint(moved), base);
+
+    auto lightSlot = BaseLoadOrder();
+    lightSlot[4].smallFileCompileIndex = 0x103;
+    EXPECT_NE(Fingerprint(lightSlot), base);
+
+    auto swapped = BaseLoadOrder();
+    std::swap(swapped[1].name, swapped[2].name);
+    EXPECT_NE(Fingerprint(swapped), base);
+}
+
+TEST(LoadOrderFingerprintTest, EncodesFullAndLightPluginFormIDs) {
+    std::uint32_t localID = 0;
+    ASSERT_TRUE(ParseLocalFormID("XX00ABCD", localID));
+    EXPECT_EQ(EncodeFormID(0x0A, 0, localID), 0x0A00ABCDu);
+    ASSERT_TRUE(ParseLocalFormID("0x801", localID));
+    EXPECT_EQ(EncodeFormID(0xFE, 0x003, localID), 0xFE003801u);
+    EXPECT_EQ(EncodeFormID(0xFE, 0xFFF, 0xFFFFFF), 0xFEFFFFFFu);
+
+    EXPECT_FALSE(ParseLocalFormID("", localID));
+    EXPECT_FALSE(ParseLocalFormID("0x", localID));
+    EXPECT_FALSE(ParseLocalFormID("12G4", localID));
+    EXPECT_FALSE(ParseLocalFormID("123456789", localID));
+}
+
+TEST_F(FormIDCacheTest, RoundTripsForTheSameLoadOrder) {
+    const std::uint64_t fingerprint = Fingerprint(BaseLoadOrder());
+    SaveEntries(fingerprint);
+
+    FormIDCache cache;
+    ASSERT_EQ(cache.Load(path_, fingerprint), FormIDCacheLoad::Loaded);
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_EQ(cache.Find(FormIDCache::QuestKey("YW_Quest")), 0x0A001234u);
+    EXPECT_EQ(cache.Find(FormIDCache::ItemKey("bwy.ESP", "xx00abcd")), 0x0A00ABCDu);
+    EXPECT_EQ(cache.Find(FormIDCache::QuestKey("Other")), 0u);
+    EXPECT_EQ(cache.Load(path_, fingerprint), FormIDCacheLoad::AlreadyLoaded);
+}
+
+TEST_F(FormIDCacheTest, UnchangedCacheIsNotRewritten) {
+    const std::uint64_t fingerprint = Fingerprint(BaseLoadOrder());
+    SaveEntries(fingerprint);
+    auto written = std::filesystem::last_write_time(path_);
+    std::filesystem::last_write_time(path_, written - std::chrono::hours(1));
+
+    FormIDCache cache;
+    ASSERT_EQ(cache.Load(path_, fingerprint), FormIDCacheLoad::Loaded);
+    cache.Store(FormIDCache::QuestKey("YW_Quest"), 0x0A001234);
+    ASSERT_TRUE(cache.Save());
+    EXPECT_EQ(std::filesystem::last_write_time(path_), written - std::chrono::hours(1));
+}
+
+TEST_F(FormIDCacheTest, AnotherLoadOrderDiscardsAndOverwritesTheFile) {
+    SaveEntries(Fingerprint(BaseLoadOrder()));
+
+    auto moved = BaseLoadOrder();
+    moved[3].compileIndex = 0x0C;
+    const std::uint64_t movedFingerprint = Fingerprint(moved);
+    {
+        FormIDCache cache;
+        ASSERT_EQ(cache.Load(path_, movedFingerprint), FormIDCacheLoad::OtherLoadOrder);
+        EXPECT_EQ(cache.Size(), 0u);
+        EXPECT_EQ(cache.Find(FormIDCache::QuestKey("YW_Quest")), 0u);
+        ASSERT_TRUE(cache.Save());
+    }
+
+    FormIDCache reloaded;
+    EXPECT_EQ(reloaded.Load(path_, movedFingerprint), FormIDCacheLoad::Loaded);
+    EXPECT_EQ(reloaded.Size(), 0u);
+    FormIDCache original;
+    EXPECT_EQ(original.Load(path_, Fingerprint(BaseLoadOrder())), FormIDCacheLoad::OtherLoadOrder);
+}
+
+TEST_F(FormIDCacheTest, DamagedFilesAreIgnored) {
+    const std::uint64_t fingerprint = Fingerprint(BaseLoadOrder());
+    {
+        std::ofstream file(path_, std::ios::binary);
+        file << "not a cache";
+    }
+    FormIDCache foreign;
+    EXPECT_EQ(foreign.Load(path_, fingerprint), FormIDCacheLoad::Missing);
+    EXPECT_EQ(foreign.Size(), 0u);
+
+    SaveEntries(fingerprint);
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 3);
+    FormIDCache truncated;
+    EXPECT_EQ(truncated.Load(path_, fingerprint), FormIDCacheLoad::Loaded);
+    EXPECT_EQ(truncated.Size(), 1u);
+}
+
+}  // namespace
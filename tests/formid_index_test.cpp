@@ -0,0 +1,66 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+std::vector<std::uint32_t> Rules(const FormIDIndex& index, std::uint32_t formID) {
+    auto found = index.Find(formID);
+    std::vector<std::uint32_t> rules(found.begin(), found.end());
+    std::sort(rules.begin(), rules.end());
+    return rules;
+}
+
+TEST(FormIDIndexTest, EmptyIndexFindsNothing) {
+    FormIDIndex index;
+    EXPECT_TRUE(index.Find(0x14).empty());
+    index.Build({});
+    EXPECT_TRUE(index.Find(0x14).empty());
+}
+
+TEST(FormIDIndexTest, GroupsEveryRuleWatchingAFormAndSkipsFormIDZero) {
+    FormIDIndex index;
+    index.Build({{0x0A001234, 2}, {0x0A001234, 0}, {0x05000800, 1}, {0, 3}, {0x0A001234, 5}});
+
+    EXPECT_EQ(Rules(index, 0x0A001234), (std::vector<std::uint32_t>{0, 2, 5}));
+    EXPECT_EQ(Rules(index, 0x05000800), (std::vector<std::uint32_t>{1}));
+    EXPECT_TRUE(index.Find(0).empty());
+    EXPECT_TRUE(index.Find(0x0A001235).empty());
+}
+
+TEST(FormIDIndexTest, MatchesASetForThousandsOfRandomForms) {
+    std::mt19937 random(42);
+    std::set<std::uint32_t> watched;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+    for (std::uint32_t rule = 0; rule < 5000; ++rule) {
+        std::uint32_t formID = random() | 1;
+        watched.insert(formID);
+        entries.emplace_back(formID, rule);
+    }
+
+    FormIDIndex index;
+    index.Build(entries);
+    for (const auto& [formID, rule] : entries) {
+        auto found = index.Find(formID);
+        EXPECT_NE(std::find(found.begin(), found.end(), rule), found.end());
+    }
+    for (int i = 0; i < 100000; ++i) {
+        std::uint32_t formID = random();
+        EXPECT_EQ(!index.Find(formID).empty(), watched.count(formID) == 1) << formID;
+    }
+}
+
+TEST(FormIDIndexTest, PlayerInventoryChangeNeedsThePlayerOnExactlyOneSide) {
+    constexpr std::uint32_t kPlayer = 0x14;
+    EXPECT_TRUE(IsPlayerInventoryChange(0x1234, kPlayer, kPlayer));
+    EXPECT_TRUE(IsPlayerInventoryChange(kPlayer, 0, kPlayer));
+    EXPECT_FALSE(IsPlayerInventoryChange(kPlayer, kPlayer, kPlayer));
+    EXPECT_FALSE(IsPlayerInventoryChange(0x1234, 0x5678, kPlayer));
+}
+
+}  // namespace
@@ -0,0 +1,71 @@
+#pragma once
+
+// Fallback driver for the fuzz targets when they are not built against libFuzzer: it feeds the target its
+// seeds and then random mutations of them (byte flips, inserts, deletes, splices), so every compiler can run
+// the target under the sanitizers. Pass --quick for a short run or --runs N.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+
+inline int RunFuzzDriver(int argc, char** argv, const std::vector<std::string>& seeds) {
+    std::size_t runs = 200000;
+    if (argc > 1 && std::strcmp(argv[1], "--quick") == 0) {
+        runs = 5000;
+    } else if (argc > 2 && std::strcmp(argv[1], "--runs") == 0) {
+        runs = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    std::mt19937_64 random(0x42575946);
+    auto pick = [&random](std::size_t bound) { return bound ? static_cast<std::size_t>(random() % bound) : 0; };
+    const std::string_view dictionary[] = {"\n", "=", "[", "]", "[Fix.", "|", ",", ";", "true", "-1", "1e39",
+                                           "99999999999", " ", "\r\n", "Enabled", "TriggerStage"};
+
+    for (const auto& seed : seeds) {
+        LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(seed.data()), seed.size());
+    }
+
+    std::string input;
+    for (std::size_t run = 0; run < runs; ++run) {
+        input = seeds[pick(seeds.size())];
+        for (std::size_t mutations = 1 + pick(8); mutations > 0; --mutations) {
+            switch (pick(5)) {
+                case 0:
+                    if (!input.empty()) {
+                        input[pick(input.size())] = static_cast<char>(random());
+                    }
+                    break;
+                case 1:
+                    input.insert(pick(input.size() + 1), dictionary[pick(std::size(dictionary))]);
+                    break;
+                case 2:
+                    if (!input.empty()) {
+                        std::size_t at = pick(input.size());
+                        input.erase(at, pick(input.size() - at) + 1);
+                    }
+                    break;
+                case 3: {
+                    const std::string& other = seeds[pick(seeds.size())];
+                    std::size_t at = pick(other.size());
+                    input.insert(pick(input.size() + 1), other, at, pick(other.size() - at) + 1);
+                    break;
+                }
+                default:
+                    input.insert(pick(input.size() + 1), 1, static_cast<char>(random()));
+                    break;
+            }
+        }
+        LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+    }
+
+    std::printf("%zu inputs run\n", runs + seeds.size());
+    return 0;
+}
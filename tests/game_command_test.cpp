@@ -0,0 +1,239 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Frame time that only passes when a simulated command says it took some.
+struct FrameClock {
+    using rep = std::int64_t;
+    using period = std::micro;
+    using duration = std::chrono::microseconds;
+    using time_point = std::chrono::time_point<FrameClock>;
+    static constexpr bool is_steady = true;
+
+    static inline duration elapsed{0};
+    static time_point now() { return time_point(elapsed); }
+};
+
+struct Completion {
+    std::uint32_t generation;
+    bool succeeded;
+};
+
+class GameCommandTest : public ::testing::Test {
+protected:
+    void SetUp() override { FrameClock::elapsed = {}; }
+
+    GameCommand Make(GameCommandKind kind, std::uint32_t formID, std::int32_t count, std::string text = {},
+                     std::uint32_t generation = 1) {
+        GameCommand command;
+        command.kind = kind;
+        command.formID = formID;
+        command.count = count;
+        command.text = std::move(text);
+        command.generation = generation;
+        command.onComplete = [this, generation](bool succeeded) { completions_.push_back({generation, succeeded}); };
+        return command;
+    }
+
+    // One game frame: every executed command costs commandCost of frame time.
+    std::size_t Frame(std::uint32_t session = 1, std::chrono::microseconds commandCost = 300us) {
+        return ring_.RunFrame<FrameClock>(
+            kGameCommandFrameBudget, session,
+            [&](GameCommand& command) {
+                executed_.push_back(command);
+                FrameClock::elapsed += commandCost;
+                if (command.kind == GameCommandKind::SetStage && refuseNativeStage_) {
+                    // Like QuestStageCallback: the refused call keeps the callback and is handed back later.
+                    refusedStages_.push_back(std::move(command));
+                    command.onComplete = nullptr;
+                    return true;
+                }
+                return command.count >= 0;
+            },
+            [this](std::function<void(bool)> onComplete, std::uint32_t, bool succeeded) {
+                if (onComplete) {
+                    onComplete(succeeded);
+                }
+            });
+    }
+
+    GameCommandRing ring_;
+    std::vector<GameCommand> executed_;
+    std::vector<Completion> completions_;
+    bool refuseNativeStage_ = false;
+    std::vector<GameCommand> refusedStages_;
+};
+
+TEST_F(GameCommandTest, StopsAtTheFrameBudgetAndResumesNextFrame) {
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, i, "n")));
+    }
+
+    // 300 us each against a 1000 us budget: the fourth starts at 900 us, the fifth would start past it.
+    EXPECT_EQ(Frame(), 4u);
+    EXPECT_EQ(Frame(), 4u);
+    EXPECT_EQ(Frame(), 2u);
+    EXPECT_EQ(Frame(), 0u);
+    ASSERT_EQ(executed_.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(executed_[i].count, i);
+    }
+    EXPECT_EQ(completions_.size(), 10u);
+}
+
+TEST_F(GameCommandTest, OneSlowCommandStillRunsEveryFrame) {
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::MessageBox, 0, 0, "a")));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::MessageBox, 0, 0, "b")));
+    EXPECT_EQ(Frame(1, 5000us), 1u);
+    EXPECT_EQ(Frame(1, 5000us), 1u);
+    EXPECT_EQ(executed_.size(), 2u);
+}
+
+TEST_F(GameCommandTest, CoalescesConsecutiveRemovalsAndConsoleCommands) {
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000800, 1)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000800, 2)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000801, 1)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::ConsoleCommand, 0, 0, "setstage A 10")));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::ConsoleCommand, 0, 0, "setstage B 20")));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "x")));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "y")));
+
+    EXPECT_EQ(Frame(1, 0us), 7u);
+    ASSERT_EQ(executed_.size(), 5u);
+    EXPECT_EQ(executed_[0].formID, 0x0A000800u);
+    EXPECT_EQ(executed_[0].count, 3);
+    EXPECT_EQ(executed_[1].formID, 0x0A000801u);
+    EXPECT_EQ(executed_[2].text, "setstage A 10\nsetstage B 20");
+    EXPECT_EQ(executed_[3].text, "x");
+    EXPECT_EQ(executed_[4].text, "y");
+    EXPECT_EQ(completions_.size(), 7u);
+}
+
+TEST_F(GameCommandTest, CoalescedCallbacksShareTheResult) {
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000800, -1)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000800, -1)));
+    Frame();
+    ASSERT_EQ(completions_.size(), 2u);
+    EXPECT_FALSE(completions_[0].succeeded);
+    EXPECT_FALSE(completions_[1].succeeded);
+}
+
+// The native call refuses the stage: its result comes back after the frame, the console route runs once in a
+// later frame, and the stage's callback fires once, with the console's result.
+TEST_F(GameCommandTest, RefusedNativeStageFallsBackToTheConsoleOnce) {
+    refuseNativeStage_ = true;
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::SetStage, 0x0A000D62, 200, "BWYQuest")));
+    EXPECT_EQ(Frame(), 1u);
+    EXPECT_TRUE(completions_.empty());
+
+    ASSERT_EQ(refusedStages_.size(), 1u);
+    ASSERT_TRUE(ring_.TryPush(MakeConsoleStageCommand(std::move(refusedStages_[0]))));
+    EXPECT_EQ(Frame(), 1u);
+    EXPECT_EQ(Frame(), 0u);
+
+    ASSERT_EQ(executed_.size(), 2u);
+    EXPECT_EQ(executed_[0].kind, GameCommandKind::SetStage);
+    EXPECT_EQ(executed_[1].kind, GameCommandKind::ConsoleCommand);
+    EXPECT_EQ(executed_[1].text, "setstage BWYQuest 200");
+    EXPECT_EQ(refusedStages_.size(), 1u);
+    ASSERT_EQ(completions_.size(), 1u);
+    EXPECT_EQ(completions_[0].generation, 1u);
+    EXPECT_TRUE(completions_[0].succeeded);
+}
+
+TEST_F(GameCommandTest, DropsCommandsFromAnotherSession) {
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000800, 1, {}, 1)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::RemoveItem, 0x0A000800, 1, {}, 2)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "any", kTimerAnySession)));
+
+    EXPECT_EQ(Frame(2), 2u);
+    ASSERT_EQ(executed_.size(), 2u);
+    EXPECT_EQ(executed_[0].generation, 2u);
+    EXPECT_EQ(executed_[0].count, 1);
+    EXPECT_EQ(executed_[1].generation, kTimerAnySession);
+    ASSERT_EQ(completions_.size(), 3u);
+    EXPECT_EQ(completions_[0].generation, 1u);
+    EXPECT_FALSE(completions_[0].succeeded);
+}
+
+// The plugin tags notifications and message boxes with the session that queued
+// them, so a "quest fixed" message still queued when another save loads never
+// shows up in that save.
+TEST_F(GameCommandTest, DropsMessagesQueuedBeforeASaveLoad) {
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "quest fixed", 1)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::MessageBox, 0, 0, "quest fixed", 1)));
+    ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "loaded", 2)));
+
+    EXPECT_EQ(Frame(2), 1u);
+    ASSERT_EQ(executed_.size(), 1u);
+    EXPECT_EQ(executed_[0].text, "loaded");
+    EXPECT_EQ(completions_.size(), 3u);
+}
+
+TEST_F(GameCommandTest, RejectsPushesWhenFull) {
+    for (std::size_t i = 0; i < kGameCommandCapacity; ++i) {
+        ASSERT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "n")));
+    }
+    EXPECT_FALSE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "n")));
+    Frame();
+    EXPECT_TRUE(ring_.TryPush(Make(GameCommandKind::Notification, 0, 0, "n")));
+}
+
+// Several monitor-side producers against a frame loop: every command runs once, each producer's in order.
+TEST_F(GameCommandTest, ProducersAndFrameLoopAgreeOnEveryCommand) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 5000;
+    std::atomic<int> running{kProducers};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                GameCommand command;
+                command.kind = GameCommandKind::SetStage;
+                command.formID = static_cast<std::uint32_t>(p);
+                command.count = i;
+                // A refused push leaves the command untouched, so the same object is offered again.
+                while (!ring_.TryPush(std::move(command))) {
+                    std::this_thread::yield();
+                }
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    bool ordered = true;
+    auto drain = [&] {
+        return ring_.RunFrame<FrameClock>(
+            kGameCommandFrameBudget, 1,
+            [&](GameCommand& command) {
+                ordered &= command.count == next[command.formID]++;
+                FrameClock::elapsed += 50us;
+                return true;
+            },
+            [](std::function<void(bool)>, std::uint32_t, bool) {});
+    };
+    while (running.load() > 0) {
+        drain();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    drain();
+    while (drain() > 0) {
+    }
+
+    EXPECT_TRUE(ordered);
+    for (int p = 0; p < kProducers; ++p) {
+        EXPECT_EQ(next[p], kPerProducer);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,73 @@
+#include "PluginCore.h"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::string DefaultDocument() {
+    std::ostringstream out;
+    WriteDefaultConfiguration(out);
+    return out.str();
+}
+
+// The default document plus rules [Fix.1]..[Fix.N], every key set.
+std::string DocumentWithRules(int rules) {
+    std::string document = DefaultDocument();
+    for (int i = 1; i <= rules; ++i) {
+        std::string n = std::to_string(i);
+        document += "\n[Fix." + n + "]\nEnabled=true\nQuestEditorID=Quest" + n + "\nQuestPlugin=Mod" + n +
+                    ".esp\nTriggerStage=" + n + "\nCompletionStage=" + std::to_string(i + 10) +
+                    "\nRequiredItems=Mod" + n + ".esp|00" + n + "A1, Mod" + n + ".esp|00" + n +
+                    "B2\nItemName=Item " + n + "\nRemoveItems=true\nDelayMs=2500\nTriggerMessage=Go\n"
+                    "DetectionMessage=Found\nCompletionMessage=Done\nShowNotification=false\n";
+    }
+    return document;
+}
+
+void BM_ParseConfiguration(benchmark::State& state) {
+    std::string document = DocumentWithRules(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        PluginConfig config;
+        ParseConfiguration(document, config);
+        benchmark::DoNotOptimize(config);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_ParseConfiguration)->Arg(0)->Arg(16)->Arg(256);
+
+// Key dispatch alone: the perfect hash against a linear scan of the table.
+void BM_FindIniFieldHash(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& field : kIniFields) {
+            benchmark::DoNotOptimize(FindIniField(field.section, field.key));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kIniFields.size()));
+}
+BENCHMARK(BM_FindIniFieldHash);
+
+void BM_FindIniFieldLinear(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& wanted : kIniFields) {
+            benchmark::DoNotOptimize(std::find_if(kIniFields.begin(), kIniFields.end(), [&](const IniField& field) {
+                return field.section == wanted.section && field.key == wanted.key;
+            }));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kIniFields.size()));
+}
+BENCHMARK(BM_FindIniFieldLinear);
+
+void BM_WriteDefaultConfiguration(benchmark::State& state) {
+    for (auto _ : state) {
+        std::ostringstream out;
+        WriteDefaultConfiguration(out);
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_WriteDefaultConfiguration);
+
+}  // namespace
@@ -0,0 +1,76 @@
+// Fuzz target for the INI parser. Besides not crashing, a parsed configuration must survive being written
+// back and parsed again unchanged, which is what SaveDefaultConfiguration and a later reload rely on.
+
+#include "PluginCore.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#ifndef BWY_LIBFUZZER
+#include "fuzz_driver.h"
+#endif
+
+namespace {
+
+// Writes every schema field and every rule with its current value.
+std::string WriteConfiguration(PluginConfig& config) {
+    std::string document;
+    for (const auto& field : kIniFields) {
+        document += "[" + std::string(field.section) + "]\n" + std::string(field.key) + "=" +
+                    FormatIniValue(field.type, field.bind(config)) + "\n";
+    }
+    for (auto& rule : config.fixes) {
+        document += "[" + rule.name + "]\n";
+        for (const auto& field : kFixRuleFields) {
+            document += std::string(field.key) + "=" + FormatIniValue(field.type, field.bind(rule)) + "\n";
+        }
+    }
+    return document;
+}
+
+// Values that cannot survive a line-based round trip are left out of the
+// comparison: text with line breaks, padding the parser trims, and floats,
+// which are written with one decimal.
+bool IsWritable(const std::string& value) {
+    return value.find_first_of("\r\n") == std::string::npos && value == TrimIniText(value);
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    std::string_view text(reinterpret_cast<const char*>(data), size);
+
+    PluginConfig config;
+    ParseConfiguration(text, config);
+    for (const auto& rule : CollectFixRules(config)) {
+        for (const auto& item : ParseRequiredItems(rule.requiredItems)) {
+            if (item.plugin != TrimIniText(item.plugin) || item.localID.find(',') != std::string_view::npos) {
+                std::abort();
+            }
+        }
+    }
+
+    PluginConfig reparsed;
+    ParseConfiguration(WriteConfiguration(config), reparsed);
+    for (const auto& field : kIniFields) {
+        if (field.type == IniValueType::Float) {
+            continue;
+        }
+        std::string before = FormatIniValue(field.type, field.bind(config));
+        if (IsWritable(before) && before != FormatIniValue(field.type, field.bind(reparsed))) {
+            std::abort();
+        }
+    }
+    return 0;
+}
+
+#ifndef BWY_LIBFUZZER
+int main(int argc, char** argv) {
+    std::ostringstream defaults;
+    WriteDefaultConfiguration(defaults);
+    return RunFuzzDriver(argc, argv,
+                         {defaults.str(), "[Fix.1]\nQuestEditorID=Q\nRequiredItems=A.esp|1,B.esp|2\nDelayMs=10\n",
+                          "[Monitoring]\nMaxDetectionDistance=-0.5e3\nCheckIntervalMs=+5\n"});
+}
+#endif
@@ -0,0 +1,149 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Warning {
+    std::string section;
+    std::string key;
+    std::string value;
+    std::string kept;
+};
+
+std::vector<Warning> g_warnings;
+
+void RecordWarning(std::string_view section, std::string_view key, std::string_view value, const std::string& kept) {
+    g_warnings.push_back({std::string(section), std::string(key), std::string(value), kept});
+}
+
+PluginConfig Parse(std::string_view text) {
+    g_warnings.clear();
+    PluginConfig config;
+    ParseConfiguration(text, config, RecordWarning);
+    return config;
+}
+
+std::string DefaultDocument() {
+    std::ostringstream out;
+    WriteDefaultConfiguration(out);
+    return out.str();
+}
+
+TEST(IniSchemaTest, HashFindsEveryFieldAndNothingElse) {
+    for (const auto& field : kIniFields) {
+        EXPECT_EQ(FindIniField(field.section, field.key), &field) << field.section << "." << field.key;
+    }
+    EXPECT_EQ(FindIniField("Quest", "Missing"), nullptr);
+    EXPECT_EQ(FindIniField("Item", "QuestEditorID"), nullptr);
+    EXPECT_EQ(FindIniField("", ""), nullptr);
+}
+
+TEST(IniSchemaTest, DefaultDocumentListsEveryFieldWithItsDefault) {
+    std::string document = DefaultDocument();
+    PluginConfig defaults;
+    for (const auto& field : kIniFields) {
+        std::string line = std::string(field.key) + "=" + FormatIniValue(field.type, field.bind(defaults)) + "\n";
+        EXPECT_NE(document.find(line), std::string::npos) << line;
+    }
+    EXPECT_NE(document.find("; [Fix.1]"), std::string::npos);
+}
+
+TEST(IniSchemaTest, EditedDefaultDocumentRoundTrips) {
+    std::string document = DefaultDocument();
+    auto replace = [&document](std::string_view from, std::string_view to) {
+        auto pos = document.find(from);
+        ASSERT_NE(pos, std::string::npos) << from;
+        document.replace(pos, from.size(), to);
+    };
+    replace("TriggerStage=21", "TriggerStage=25");
+    replace("CheckIntervalMs=1000", "CheckIntervalMs=250");
+    replace("MaxDetectionDistance=5000.0", "MaxDetectionDistance=1234.5");
+    replace("SecondaryMirror=Sync", "SecondaryMirror=Async");
+    replace("WriteIndex=true", "WriteIndex=false");
+
+    PluginConfig config = Parse(document);
+    EXPECT_TRUE(g_warnings.empty());
+    EXPECT_EQ(config.quest.triggerStage, 25);
+    EXPECT_EQ(config.monitoring.checkIntervalMs, 250);
+    EXPECT_FLOAT_EQ(config.monitoring.maxDetectionDistance, 1234.5f);
+    EXPECT_EQ(config.logging.secondaryMirror, "Async");
+    EXPECT_FALSE(config.logging.writeIndex);
+    EXPECT_EQ(config.quest.questEditorID, PluginConfig().quest.questEditorID);
+    EXPECT_TRUE(config.fixes.empty());
+}
+
+TEST(IniSchemaTest, MalformedValuesKeepTheCurrentSettingAndWarn) {
+    PluginConfig config = Parse("[Quest]\nTriggerStage=twenty\n[Monitoring]\nCheckIntervalMs=99999999999\n"
+                                "MaxDetectionDistance=12.5x\n");
+    EXPECT_EQ(config.quest.triggerStage, 21);
+    EXPECT_EQ(config.monitoring.checkIntervalMs, 1000);
+    EXPECT_FLOAT_EQ(config.monitoring.maxDetectionDistance, 5000.0f);
+    ASSERT_EQ(g_warnings.size(), 3u);
+    EXPECT_EQ(g_warnings[0].section, "Quest");
+    EXPECT_EQ(g_warnings[0].key, "TriggerStage");
+    EXPECT_EQ(g_warnings[0].value, "twenty");
+    EXPECT_EQ(g_warnings[0].kept, "21");
+    EXPECT_EQ(g_warnings[2].kept, "5000.0");
+}
+
+TEST(IniSchemaTest, BoolsAcceptZeroOneTrueFalseInAnyCaseAndWarnOtherwise) {
+    PluginConfig config = Parse("[Quest]\nEnabled=FALSE\nShowNotification=0\n[Item]\nEnabled=0\nEnabled=tRuE\n"
+                                "[Logging]\nWriteIndex=False\nBinaryLog=1\n");
+    EXPECT_TRUE(g_warnings.empty());
+    EXPECT_FALSE(config.quest.enabled);
+    EXPECT_FALSE(config.quest.showNotification);
+    EXPECT_TRUE(config.item.enabled);
+    EXPECT_FALSE(config.logging.writeIndex);
+    EXPECT_TRUE(config.logging.binaryLog);
+
+    config = Parse("[Quest]\nEnabled=yes\n[Logging]\nWriteIndex=off\nQuestLog=2\n");
+    EXPECT_EQ(config.quest.enabled, PluginConfig().quest.enabled);
+    EXPECT_EQ(config.logging.writeIndex, PluginConfig().logging.writeIndex);
+    EXPECT_EQ(config.logging.questLog, PluginConfig().logging.questLog);
+    ASSERT_EQ(g_warnings.size(), 3u);
+    EXPECT_EQ(g_warnings[0].key, "Enabled");
+    EXPECT_EQ(g_warnings[0].value, "yes");
+    EXPECT_EQ(g_warnings[0].kept, FormatIniValue(IniValueType::Bool, &config.quest.enabled));
+    EXPECT_EQ(g_warnings[1].value, "off");
+    EXPECT_EQ(g_warnings[2].value, "2");
+}
+
+TEST(IniSchemaTest, IgnoresCommentsUnknownKeysAndStrayLines) {
+    PluginConfig config = Parse("; comment\n# other\n[Quest]\nUnknown=1\nno equals sign\n  TriggerStage = 7 \r\n"
+                                "[Unknown]\nTriggerStage=8\n");
+    EXPECT_EQ(config.quest.triggerStage, 7);
+    EXPECT_TRUE(g_warnings.empty());
+}
+
+TEST(IniSchemaTest, FixSectionsBecomeRulesAfterTheLegacyOne) {
+    PluginConfig config = Parse("[Fix.2]\nQuestEditorID=SecondQuest\nTriggerStage=10\nDelayMs=oops\n"
+                                "RequiredItems=A.esp|000801, B.esm | 12AB ,broken\n"
+                                "[Notification]\nEnabled=false\n"
+                                "[Fix.2]\nCompletionStage=20\n");
+    ASSERT_EQ(config.fixes.size(), 1u);
+    EXPECT_EQ(config.fixes[0].name, "Fix.2");
+    EXPECT_EQ(config.fixes[0].completionStage, 20);
+    EXPECT_EQ(config.fixes[0].delayMs, 5000);
+    ASSERT_EQ(g_warnings.size(), 1u);
+    EXPECT_EQ(g_warnings[0].section, "Fix.2");
+
+    auto items = ParseRequiredItems(config.fixes[0].requiredItems);
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[1].plugin, "B.esm");
+    EXPECT_EQ(items[1].localID, "12AB");
+
+    auto rules = CollectFixRules(config);
+    ASSERT_EQ(rules.size(), 2u);
+    EXPECT_EQ(rules[0].name, "Quest");
+    EXPECT_EQ(rules[0].requiredItems, "YurianaWench.esp|625C7C");
+    EXPECT_FALSE(rules[0].showNotification);
+    EXPECT_EQ(rules[1].questEditorID, "SecondQuest");
+    EXPECT_FALSE(rules[1].showNotification);
+}
+
+}  // namespace
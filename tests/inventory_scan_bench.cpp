@@ -0,0 +1,47 @@
+#include "synthetic_inventory.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::size_t kWatchedItems = 8;
+
+// The former reconcile: materialize the inventory, then find every watched item in the map.
+void BM_GetInventoryThenFind(benchmark::State& state) {
+    SyntheticInventory inventory =
+        MakeSyntheticInventory(static_cast<std::size_t>(state.range(0)), kWatchedItems, kWatchedItems);
+    std::array<std::int32_t, kWatchedItems> found{};
+    for (auto _ : state) {
+        MaterializedInventory items = MaterializeInventory(inventory);
+        for (std::size_t i = 0; i < kWatchedItems; ++i) {
+            auto it = items.find(inventory.watched[i]);
+            found[i] = it != items.end() ? it->second.first : 0;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_GetInventoryThenFind)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Every watched item is carried, so the changes walk stops at the last one it meets.
+void BM_InPlaceScan(benchmark::State& state) {
+    SyntheticInventory inventory =
+        MakeSyntheticInventory(static_cast<std::size_t>(state.range(0)), kWatchedItems, kWatchedItems);
+    WatchedItemCounts counts(inventory.watched);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ScanInventory(counts, inventory));
+    }
+}
+BENCHMARK(BM_InPlaceScan)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Half the watched items are missing, so the walk runs to the end of the list.
+void BM_InPlaceScanNoEarlyExit(benchmark::State& state) {
+    SyntheticInventory inventory =
+        MakeSyntheticInventory(static_cast<std::size_t>(state.range(0)), kWatchedItems, kWatchedItems / 2);
+    WatchedItemCounts counts(inventory.watched);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ScanInventory(counts, inventory));
+    }
+}
+BENCHMARK(BM_InPlaceScanNoEarlyExit)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace
@@ -0,0 +1,185 @@
+// Heap allocations and producer-side time per quest stage event for the three generations of log call
+// sites in QuestStageEventSink: string messages built with operator+ and std::to_string, fixed banners as
+// deferred records, and the format-string API that writes straight into the record buffer. The plugin
+// formats with std::format; this harness uses fmt with the same format strings, which behaves the same way
+// for allocation purposes. Exits non-zero if the current call sites allocate. Pass --quick for a short run.
+
+#include "PluginCore.h"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <source_location>
+#include <string>
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+// Editor IDs come back from the game as const char*; the old sink copied it into a std::string.
+const char* const kQuestEditorID = "YW_Quest_MDF_MainQuestline";
+
+std::unique_ptr<LogRingBuffer> g_questRing = std::make_unique<LogRingBuffer>();
+std::atomic<bool> g_questChannelEnabled{true};
+
+std::int64_t NowMs(std::chrono::system_clock::time_point now) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+}
+
+// Before: WriteToQuestLog(const std::string&, int) behind string-building call sites.
+void WriteToQuestLog(const std::string& message, int lineNumber) {
+    if (!g_questChannelEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    char line[kLogRecordTextSize];
+    auto now = std::chrono::system_clock::now();
+    std::size_t length = FormatLogLine(line, now, LogChannel::Quest, LogLevel::Info,
+                                       static_cast<std::uint_least32_t>(lineNumber), message);
+    g_questRing->TryPush(LogRecordKind::Text, NowMs(now), std::string_view(line, length));
+}
+
+template <class... Args>
+void WriteDeferredLog(LogFormatId format, std::uint32_t lineNumber, Args... args) {
+    if (!g_questChannelEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    DeferredLogRecord record;
+    record.timestampMs = NowMs(std::chrono::system_clock::now());
+    record.format = format;
+    record.lineNumber = lineNumber;
+    [[maybe_unused]] std::size_t index = 0;
+    ((record.args[index++] = static_cast<std::int64_t>(args)), ...);
+    g_questRing->TryPush(LogRecordKind::Deferred, record.timestampMs,
+                         std::string_view(reinterpret_cast<const char*>(&record), sizeof(record)));
+}
+
+// After: the LogQuest front end, with the line number taken from std::source_location.
+template <class... Args>
+struct LogFormatString {
+    template <class T>
+        requires std::convertible_to<const T&, std::string_view>
+    consteval LogFormatString(const T& text, std::source_location location = std::source_location::current())
+        : format(text), lineNumber(location.line()) {}
+
+    fmt::format_string<Args...> format;
+    std::uint_least32_t lineNumber;
+};
+
+template <class... Args>
+void LogQuest(LogFormatString<std::type_identity_t<Args>...> format, Args&&... args) {
+    if (!g_questChannelEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    char line[kLogRecordTextSize];
+    char* const end = line + kLogRecordTextSize;
+    auto now = std::chrono::system_clock::now();
+    char* out = FormatLogPrefix(line, now, LogChannel::Quest, LogLevel::Info, format.lineNumber);
+    out = fmt::format_to_n(out, end - out, format.format, std::forward<Args>(args)...).out;
+    g_questRing->TryPush(LogRecordKind::Text, NowMs(now), std::string_view(line, out - line));
+}
+
+void StringCallSites(int newStage) {
+    std::string questEditorID = kQuestEditorID;
+    WriteToQuestLog("========================================", __LINE__);
+    WriteToQuestLog("QUEST STAGE EVENT RECEIVED", __LINE__);
+    WriteToQuestLog("Quest: " + questEditorID, __LINE__);
+    WriteToQuestLog("New Stage: " + std::to_string(newStage), __LINE__);
+    WriteToQuestLog("========================================", __LINE__);
+}
+
+void DeferredBannerCallSites(int newStage) {
+    std::string questEditorID = kQuestEditorID;
+    WriteDeferredLog(LogFormatId::Separator, __LINE__);
+    WriteDeferredLog(LogFormatId::QuestStageEventReceived, __LINE__);
+    WriteToQuestLog("Quest: " + questEditorID, __LINE__);
+    WriteDeferredLog(LogFormatId::NewStage, __LINE__, newStage);
+    WriteDeferredLog(LogFormatId::Separator, __LINE__);
+}
+
+// The editor ID now comes from the published rule table instead of a per-event copy.
+const std::string g_ruleQuestEditorID = kQuestEditorID;
+
+void FormatCallSites(int newStage) {
+    WriteDeferredLog(LogFormatId::Separator, __LINE__);
+    WriteDeferredLog(LogFormatId::QuestStageEventReceived, __LINE__);
+    LogQuest("Quest: {}", g_ruleQuestEditorID);
+    WriteDeferredLog(LogFormatId::NewStage, __LINE__, newStage);
+    WriteDeferredLog(LogFormatId::Separator, __LINE__);
+}
+
+struct EventCost {
+    double allocationsPerEvent;
+    double nanosPerEvent;
+};
+
+template <class Fn>
+EventCost Measure(Fn&& event, std::size_t events) {
+    auto discard = [](LogRecordKind, std::int64_t, std::string_view) {};
+    std::size_t allocations = 0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    for (std::size_t i = 0; i < events; ++i) {
+        std::size_t before = g_allocations.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        event(static_cast<int>(i % 200));
+        elapsed += std::chrono::steady_clock::now() - start;
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+
+        g_questRing->Drain(discard);
+    }
+
+    return {static_cast<double>(allocations) / static_cast<double>(events),
+            std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(events)};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    const std::size_t events = quick ? 2000 : 200000;
+
+    struct Variant {
+        const char* name;
+        void (*event)(int);
+    };
+    const Variant variants[] = {{"string call sites", StringCallSites},
+                                {"deferred banners", DeferredBannerCallSites},
+                                {"format API", FormatCallSites}};
+
+    EventCost current{};
+    std::printf("%-20s %-8s %14s %12s\n", "call sites", "channel", "allocs/event", "ns/event");
+    for (bool enabled : {true, false}) {
+        g_questChannelEnabled.store(enabled, std::memory_order_relaxed);
+        for (const auto& variant : variants) {
+            EventCost cost = Measure(variant.event, events);
+            std::printf("%-20s %-8s %14.2f %12.0f\n", variant.name, enabled ? "on" : "muted",
+                        cost.allocationsPerEvent, cost.nanosPerEvent);
+            if (variant.event == FormatCallSites) {
+                current.allocationsPerEvent += cost.allocationsPerEvent;
+            }
+        }
+    }
+
+    return current.allocationsPerEvent == 0.0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// Contention benchmark for the per-channel log rings: N producer threads spread over the three channels
+// push preformatted lines, and the throughput is compared with the former design, where every channel
+// appended to its in-memory tail under one global mutex. Pass --quick for a short run.
+
+#include "PluginCore.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTailLines = 2000;
+const std::string_view kLine = "[2024-01-01 12:00:00.000] [quest] [info] [plugin.cpp:1234] Quest stage changed: 20 -> 21";
+
+// Before: g_logMutex serialises every channel, and each line is copied into a deque-backed tail.
+struct GlobalMutexLogger {
+    std::mutex mutex;
+    std::array<std::deque<std::string>, kLogChannelCount> tails;
+
+    void Push(std::size_t channel, std::string_view line) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& tail = tails[channel];
+        tail.emplace_back(line);
+        if (tail.size() > kTailLines) {
+            tail.pop_front();
+        }
+    }
+};
+
+// After: one ring per channel and a single writer thread draining all three.
+struct ShardedLogger {
+    std::array<std::unique_ptr<LogRingBuffer>, kLogChannelCount> rings;
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> drained{0};
+    std::thread writer;
+
+    ShardedLogger() {
+        for (auto& ring : rings) {
+            ring = std::make_unique<LogRingBuffer>();
+        }
+        writer = std::thread([this] {
+            char batch[kLogRecordTextSize];
+            auto sink = [&](LogRecordKind, std::int64_t, std::string_view payload) {
+                std::memcpy(batch, payload.data(), payload.size());
+            };
+            while (!stop.load(std::memory_order_acquire)) {
+                std::size_t count = 0;
+                for (auto& ring : rings) {
+                    count += ring->Drain(sink);
+                }
+                drained.fetch_add(count, std::memory_order_relaxed);
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    ~ShardedLogger() {
+        stop.store(true, std::memory_order_release);
+        writer.join();
+    }
+
+    void Push(std::size_t channel, std::string_view line) {
+        // A full ring drops the record, as in the plugin; the producer never waits.
+        rings[channel]->TryPush(LogRecordKind::Text, 0, line);
+    }
+
+    std::size_t TakeDropped() {
+        std::size_t dropped = 0;
+        for (auto& ring : rings) {
+            dropped += ring->TakeDroppedCount();
+        }
+        return dropped;
+    }
+};
+
+template <class Logger>
+double MeasureLinesPerSecond(Logger& logger, std::size_t producers, std::size_t linesPerProducer) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&logger, &go, p, linesPerProducer] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < linesPerProducer; ++i) {
+                logger.Push((p + i) % kLogChannelCount, kLine);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(producers * linesPerProducer) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    const std::size_t linesPerProducer = quick ? 20000 : 1000000;
+
+    std::printf("%-10s %20s %20s %8s %10s\n", "producers", "global mutex (l/s)", "per-channel (l/s)", "speedup",
+                "dropped");
+    for (std::size_t producers : {1, 2, 4, 8}) {
+        GlobalMutexLogger before;
+        double beforeRate = MeasureLinesPerSecond(before, producers, linesPerProducer);
+
+        ShardedLogger after;
+        double afterRate = MeasureLinesPerSecond(after, producers, linesPerProducer);
+
+        std::printf("%-10zu %20.0f %20.0f %7.1fx %10zu\n", producers, beforeRate, afterRate, afterRate / beforeRate,
+                    after.TakeDropped());
+    }
+    return 0;
+}
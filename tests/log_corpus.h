@@ -0,0 +1,110 @@
+#pragma once
+
+// Writes log segments, binary logs and sidecar indexes into a directory the way the plugin's LogPathWriter does,
+// so the index tests and the query benchmark read files laid out exactly like a player's log folder.
+
+#include "PluginCore.h"
+
+#include <array>
+#include <fstream>
+#include <memory>
+
+class LogCorpusWriter {
+public:
+    explicit LogCorpusWriter(std::filesystem::path directory) : directory_(std::move(directory)) {
+        std::filesystem::create_directories(directory_);
+    }
+
+    // Appends the batch to the channel's live segment and binary log, rebases
+    // its index entries onto them and clears it for the next batch.
+    void Write(LogChannel channel, LogBatch& batch) {
+        auto channelIndex = static_cast<std::size_t>(channel);
+        if (!logFiles_[channelIndex]) {
+            logFiles_[channelIndex] = std::make_unique<std::ofstream>(directory_ / GetLogFileName(channel),
+                                                                       std::ios::binary | std::ios::app);
+            indexFiles_[channelIndex] = std::make_unique<std::ofstream>(GetLogIndexPath(directory_, channel, 0),
+                                                                         std::ios::binary | std::ios::app);
+            binaryFiles_[channelIndex] = std::make_unique<std::ofstream>(GetBinaryLogPath(directory_, channel, 0),
+                                                                          std::ios::binary | std::ios::app);
+        }
+
+        for (auto& entry : batch.Seal(channel)) {
+            entry.offset += (entry.flags & kLogIndexBinary) != 0 ? binaryOffsets_[channelIndex]
+                                                                 : segmentOffsets_[channelIndex];
+        }
+        indexFiles_[channelIndex]->write(reinterpret_cast<const char*>(batch.index.data()),
+                                         static_cast<std::streamsize>(batch.index.size() * sizeof(LogIndexEntry)));
+        logFiles_[channelIndex]->write(batch.text.data(), static_cast<std::streamsize>(batch.text.size()));
+        binaryFiles_[channelIndex]->write(batch.binary.data(), static_cast<std::streamsize>(batch.binary.size()));
+
+        segmentOffsets_[channelIndex] += batch.text.size();
+        binaryOffsets_[channelIndex] += batch.binary.size();
+        bytesWritten_ += batch.text.size() + batch.binary.size();
+        batch.Clear();
+    }
+
+    // Shifts the live segment and its index to ".1", pushing older ones up.
+    void Rotate(LogChannel channel) {
+        auto channelIndex = static_cast<std::size_t>(channel);
+        logFiles_[channelIndex].reset();
+        indexFiles_[channelIndex].reset();
+        binaryFiles_[channelIndex].reset();
+        segmentOffsets_[channelIndex] = 0;
+        binaryOffsets_[channelIndex] = 0;
+
+        std::size_t oldest = 1;
+        while (std::filesystem::exists(GetLogSegmentPath(directory_, channel, oldest))) {
+            ++oldest;
+        }
+        for (std::size_t index = oldest; index > 1; --index) {
+            std::filesystem::rename(GetLogSegmentPath(directory_, channel, index - 1),
+                                    GetLogSegmentPath(directory_, channel, index));
+            std::filesystem::rename(GetLogIndexPath(directory_, channel, index - 1),
+                                    GetLogIndexPath(directory_, channel, index));
+            std::filesystem::rename(GetBinaryLogPath(directory_, channel, index - 1),
+                                    GetBinaryLogPath(directory_, channel, index));
+        }
+        std::filesystem::rename(directory_ / GetLogFileName(channel), GetLogSegmentPath(directory_, channel, 1));
+        std::filesystem::rename(GetLogIndexPath(directory_, channel, 0), GetLogIndexPath(directory_, channel, 1));
+        std::filesystem::rename(GetBinaryLogPath(directory_, channel, 0), GetBinaryLogPath(directory_, channel, 1));
+    }
+
+    void Close() {
+        for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+            logFiles_[i].reset();
+            indexFiles_[i].reset();
+            binaryFiles_[i].reset();
+        }
+    }
+
+    std::uint64_t BytesWritten() const { return bytesWritten_; }
+
+private:
+    std::filesystem::path directory_;
+    std::array<std::unique_ptr<std::ofstream>, kLogChannelCount> logFiles_;
+    std::array<std::unique_ptr<std::ofstream>, kLogChannelCount> indexFiles_;
+    std::array<std::unique_ptr<std::ofstream>, kLogChannelCount> binaryFiles_;
+    std::array<std::uint64_t, kLogChannelCount> segmentOffsets_{};
+    std::array<std::uint64_t, kLogChannelCount> binaryOffsets_{};
+    std::uint64_t bytesWritten_ = 0;
+};
+
+// A text record as the producers push it: the fully formatted line.
+inline void AppendTextLine(LogBatch& batch, LogChannel channel, std::int64_t timestampMs, std::string_view message,
+                           std::uint_least32_t lineNumber = 100) {
+    char line[kLogRecordTextSize];
+    std::chrono::system_clock::time_point time{std::chrono::milliseconds(timestampMs)};
+    std::size_t length = FormatLogLine(line, time, channel, LogLevel::Info, lineNumber, message);
+    batch.Append(channel, LogRecordKind::Text, timestampMs, std::string_view(line, length));
+}
+
+inline void AppendDeferredLine(LogBatch& batch, LogChannel channel, std::int64_t timestampMs, LogFormatId format,
+                               std::int64_t arg = 0) {
+    DeferredLogRecord record;
+    record.timestampMs = timestampMs;
+    record.format = format;
+    record.lineNumber = 200;
+    record.args[0] = arg;
+    batch.Append(channel, LogRecordKind::Deferred, timestampMs,
+                 std::string_view(reinterpret_cast<const char*>(&record), sizeof(record)));
+}
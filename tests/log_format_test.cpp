@@ -0,0 +1,53 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include <limits>
+#include <string>
+
+namespace {
+
+std::string Render(std::string_view format, std::array<std::int64_t, kDeferredLogMaxArgs> args) {
+    char out[kLogRecordTextSize];
+    return std::string(out, RenderLogFormat(out, out + sizeof(out), format, args));
+}
+
+// The writer used to render deferred records with std::vformat; the portable
+// renderer must produce the same text for every format the plugin logs.
+TEST(LogFormatTest, RendersEveryDeferredFormatLikeFormat) {
+    const std::int64_t samples[] = {0, 7, 255, 0x0001A2B3, -12, std::numeric_limits<std::int64_t>::max()};
+    for (auto format : kLogFormats) {
+        for (std::int64_t sample : samples) {
+            std::array<std::int64_t, kDeferredLogMaxArgs> args = {sample, sample / 2, 0, 0};
+            EXPECT_EQ(Render(format, args),
+                      fmt::vformat(fmt::string_view(format.data(), format.size()),
+                                   fmt::make_format_args(args[0], args[1], args[2], args[3])))
+                << format;
+        }
+    }
+}
+
+TEST(LogFormatTest, LeavesUnknownPlaceholdersAlone) {
+    EXPECT_EQ(Render("{:d} {}", {5, 0, 0, 0}), "{:d} 5");
+}
+
+TEST(LogFormatTest, LinePrefixCarriesChannelLevelAndLine) {
+    char line[kLogRecordTextSize];
+    std::size_t length = FormatLogLine(line, std::chrono::system_clock::now(), LogChannel::Actions,
+                                       LogLevel::Warning, 1234, "message");
+    std::string text(line, length);
+    EXPECT_EQ(text.substr(0, 1), "[");
+    EXPECT_TRUE(text.ends_with("] [log] [warning] [plugin.cpp:1234] message")) << text;
+}
+
+TEST(LogFormatTest, TruncatesAtRecordSize) {
+    char line[kLogRecordTextSize];
+    std::string message(kLogRecordTextSize * 2, 'm');
+    std::size_t length =
+        FormatLogLine(line, std::chrono::system_clock::now(), LogChannel::System, LogLevel::Info, 1, message);
+    EXPECT_EQ(length, kLogRecordTextSize);
+}
+
+}  // namespace
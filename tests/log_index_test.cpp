@@ -0,0 +1,238 @@
+#include "log_corpus.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::int64_t kBaseMs = 1700000000000;
+
+class LogIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("bwy_index_" + std::to_string(getpid()) + "_" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory_);
+    }
+    void TearDown() override { std::filesystem::remove_all(directory_); }
+
+    std::filesystem::path directory_;
+};
+
+std::vector<std::string> Texts(const std::vector<LogQueryLine>& lines) {
+    std::vector<std::string> texts;
+    for (const auto& line : lines) {
+        std::string_view text = line.text;
+        texts.emplace_back(text.substr(text.rfind("] ") + 2));
+    }
+    return texts;
+}
+
+TEST(LogTimestampTest, ParsesWhatTheFormatterWrites) {
+    for (std::int64_t ms : {kBaseMs, kBaseMs + 999, kBaseMs + 86400123}) {
+        char text[kTimestampLength];
+        FormatTimestamp(std::chrono::system_clock::time_point{std::chrono::milliseconds(ms)}, text);
+        EXPECT_EQ(ParseLogTimestamp(std::string_view(text, kTimestampLength)), ms);
+    }
+    EXPECT_FALSE(ParseLogTimestamp("[log writer] WARNING"));
+}
+
+TEST(LogBatchTest, EventEntriesPointAtTheirLines) {
+    LogBatch batch;
+    AppendTextLine(batch, LogChannel::Quest, kBaseMs, "before");
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 5, LogFormatId::TriggerStageReached);
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 6, LogFormatId::Stage, 30);
+
+    auto entries = batch.Seal(LogChannel::Quest);
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].event, static_cast<std::uint16_t>(LogFormatId::TriggerStageReached));
+    EXPECT_TRUE(std::string_view(batch.text)
+                    .substr(entries[0].offset, entries[0].length)
+                    .ends_with("TRIGGER STAGE REACHED"));
+    EXPECT_EQ(entries[1].event, kLogIndexBatchEvent);
+    EXPECT_EQ(entries[1].firstTimestampMs, kBaseMs);
+    EXPECT_EQ(entries[1].lastTimestampMs, kBaseMs + 6);
+    EXPECT_EQ(entries[1].length, batch.text.size());
+    EXPECT_EQ(batch.lines, 3u);
+}
+
+TEST(LogBatchTest, BinaryEventEntriesPointAtTheirRecords) {
+    LogBatch batch;
+    batch.binaryDeferred = true;
+    AppendTextLine(batch, LogChannel::Quest, kBaseMs, "before");
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 5, LogFormatId::Stage, 21);
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 6, LogFormatId::TriggerStageReached);
+
+    auto entries = batch.Seal(LogChannel::Quest);
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].event, static_cast<std::uint16_t>(LogFormatId::TriggerStageReached));
+    EXPECT_EQ(entries[0].flags, kLogIndexBinary);
+    std::vector<DeferredLogRecord> records;
+    std::string_view chunk = std::string_view(batch.binary).substr(entries[0].offset, entries[0].length);
+    EXPECT_TRUE(DecodeBinaryLogChunk(chunk, LogChannel::Quest, entries[0].firstTimestampMs,
+                                     [&records](LogChannel, const DeferredLogRecord& record) {
+                                         records.push_back(record);
+                                     }));
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].format, LogFormatId::TriggerStageReached);
+    EXPECT_EQ(records[0].timestampMs, kBaseMs + 6);
+
+    EXPECT_EQ(entries[1].event, kLogIndexBatchEvent);
+    EXPECT_EQ(entries[1].flags, 0);
+    EXPECT_EQ(entries[1].length, batch.text.size());
+    EXPECT_EQ(entries[2].event, kLogIndexBatchEvent);
+    EXPECT_EQ(entries[2].flags, kLogIndexBinary);
+    EXPECT_EQ(entries[2].firstTimestampMs, kBaseMs + 5);
+    EXPECT_EQ(entries[2].lastTimestampMs, kBaseMs + 6);
+    EXPECT_EQ(entries[2].length, batch.binary.size());
+}
+
+TEST_F(LogIndexTest, FindsEventsFromTheIndexAlone) {
+    LogCorpusWriter writer(directory_);
+    LogBatch batch;
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 100, LogFormatId::QuestActivated);
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 200, LogFormatId::TriggerStageReached);
+    writer.Write(LogChannel::Quest, batch);
+    AppendDeferredLine(batch, LogChannel::Actions, kBaseMs + 300, LogFormatId::ItemDetected);
+    writer.Write(LogChannel::Actions, batch);
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 400, LogFormatId::TriggerStageReached);
+    writer.Write(LogChannel::Quest, batch);
+    writer.Close();
+
+    auto hits = FindLogEvents(directory_, LogFormatId::TriggerStageReached);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0].timestampMs, kBaseMs + 200);
+    EXPECT_EQ(hits[1].timestampMs, kBaseMs + 400);
+    EXPECT_EQ(hits[0].channel, LogChannel::Quest);
+
+    auto detected = FindLogEvents(directory_, LogFormatId::ItemDetected);
+    ASSERT_EQ(detected.size(), 1u);
+    EXPECT_EQ(detected[0].channel, LogChannel::Actions);
+}
+
+TEST_F(LogIndexTest, MergesChannelsByTimeWithinTheWindow) {
+    LogCorpusWriter writer(directory_);
+    LogBatch batch;
+    for (int i = 0; i < 10; ++i) {
+        AppendTextLine(batch, LogChannel::Actions, kBaseMs + i * 1000, "actions " + std::to_string(i));
+        writer.Write(LogChannel::Actions, batch);
+        AppendTextLine(batch, LogChannel::Quest, kBaseMs + i * 1000 + 300, "quest " + std::to_string(i));
+        writer.Write(LogChannel::Quest, batch);
+        AppendTextLine(batch, LogChannel::System, kBaseMs + i * 1000 + 600, "system " + std::to_string(i));
+        writer.Write(LogChannel::System, batch);
+    }
+    writer.Close();
+
+    auto lines = QueryLogWindow(directory_, kBaseMs + 3300, kBaseMs + 5000);
+    std::vector<std::string> expected = {"quest 3", "system 3", "actions 4", "quest 4", "system 4", "actions 5"};
+    EXPECT_EQ(Texts(lines), expected);
+    EXPECT_EQ(lines[1].channel, LogChannel::System);
+}
+
+TEST_F(LogIndexTest, ReadsAcrossRotatedSegmentsOldestFirst) {
+    LogCorpusWriter writer(directory_);
+    LogBatch batch;
+    for (int segment = 0; segment < 3; ++segment) {
+        for (int i = 0; i < 4; ++i) {
+            AppendTextLine(batch, LogChannel::Quest, kBaseMs + segment * 10000 + i, std::to_string(segment * 10 + i));
+        }
+        writer.Write(LogChannel::Quest, batch);
+        if (segment < 2) {
+            writer.Rotate(LogChannel::Quest);
+        }
+    }
+    writer.Close();
+
+    auto lines = QueryLogWindow(directory_, kBaseMs + 3, kBaseMs + 20001);
+    std::vector<std::string> expected = {"3", "10", "11", "12", "13", "20", "21"};
+    EXPECT_EQ(Texts(lines), expected);
+}
+
+// With BinaryLog on, banner events are still found from the index, and a
+// query renders the binary records between the text lines, including batches
+// in a rotated segment and ones that continue a session started before it.
+TEST_F(LogIndexTest, QueriesBinaryRecordsLikeText) {
+    LogCorpusWriter writer(directory_);
+    LogBatch batch;
+    batch.binaryDeferred = true;
+    AppendTextLine(batch, LogChannel::Quest, kBaseMs, "before");
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 5, LogFormatId::TriggerStageReached);
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 6, LogFormatId::Stage, 30);
+    writer.Write(LogChannel::Quest, batch);
+    writer.Rotate(LogChannel::Quest);
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 10000, LogFormatId::QuestActivated);
+    AppendTextLine(batch, LogChannel::Quest, kBaseMs + 10001, "after");
+    AppendDeferredLine(batch, LogChannel::Quest, kBaseMs + 10002, LogFormatId::FormID, 0x625C7C);
+    writer.Write(LogChannel::Quest, batch);
+    writer.Close();
+
+    auto triggers = FindLogEvents(directory_, LogFormatId::TriggerStageReached);
+    ASSERT_EQ(triggers.size(), 1u);
+    EXPECT_EQ(triggers[0].timestampMs, kBaseMs + 5);
+    auto activated = FindLogEvents(directory_, LogFormatId::QuestActivated);
+    ASSERT_EQ(activated.size(), 1u);
+    EXPECT_EQ(activated[0].timestampMs, kBaseMs + 10000);
+
+    auto lines = QueryLogWindow(directory_, kBaseMs, kBaseMs + 20000);
+    std::vector<std::string> expected = {"before",          "TRIGGER STAGE REACHED", "Stage: 30",
+                                         "QUEST ACTIVATED", "after",                 "FormID: 0x625C7C"};
+    EXPECT_EQ(Texts(lines), expected);
+    EXPECT_EQ(lines[2].timestampMs, kBaseMs + 6);
+
+    EXPECT_EQ(Texts(QueryLogWindow(directory_, kBaseMs + 6, kBaseMs + 10000)),
+              (std::vector<std::string>{"Stage: 30", "QUEST ACTIVATED"}));
+}
+
+// Game start clears the segments an earlier session rotated out, so its lines
+// can never come back through a query of the current session.
+TEST_F(LogIndexTest, StartupRemovesRotatedSegmentsOfEarlierSessions) {
+    LogCorpusWriter writer(directory_);
+    LogBatch batch;
+    for (int segment = 0; segment < 3; ++segment) {
+        AppendTextLine(batch, LogChannel::Quest, kBaseMs + segment, "earlier " + std::to_string(segment));
+        writer.Write(LogChannel::Quest, batch);
+        writer.Rotate(LogChannel::Quest);
+    }
+    AppendTextLine(batch, LogChannel::Actions, kBaseMs + 5, "other channel");
+    writer.Write(LogChannel::Actions, batch);
+    writer.Rotate(LogChannel::Actions);
+    AppendTextLine(batch, LogChannel::Actions, kBaseMs + 6, "other channel, live");
+    writer.Write(LogChannel::Actions, batch);
+    writer.Close();
+    ASSERT_TRUE(std::filesystem::exists(GetLogSegmentPath(directory_, LogChannel::Quest, 3)));
+
+    RemoveRotatedLogSegments(directory_, LogChannel::Quest);
+    for (std::size_t index = 1; index <= 3; ++index) {
+        EXPECT_FALSE(std::filesystem::exists(GetLogSegmentPath(directory_, LogChannel::Quest, index)));
+        EXPECT_FALSE(std::filesystem::exists(GetLogIndexPath(directory_, LogChannel::Quest, index)));
+        EXPECT_FALSE(std::filesystem::exists(GetBinaryLogPath(directory_, LogChannel::Quest, index)));
+    }
+    EXPECT_TRUE(std::filesystem::exists(GetLogSegmentPath(directory_, LogChannel::Actions, 1)));
+
+    LogCorpusWriter session(directory_);
+    AppendTextLine(batch, LogChannel::Quest, kBaseMs + 100, "current");
+    session.Write(LogChannel::Quest, batch);
+    session.Close();
+    EXPECT_EQ(Texts(QueryLogWindow(directory_, kBaseMs, kBaseMs + 100)),
+              (std::vector<std::string>{"other channel", "other channel, live", "current"}));
+}
+
+TEST_F(LogIndexTest, UntimedLinesFollowTheLineBeforeThem) {
+    LogCorpusWriter writer(directory_);
+    LogBatch batch;
+    AppendTextLine(batch, LogChannel::System, kBaseMs + 10, "timed");
+    batch.AppendLine("[log writer] WARNING: 3 log record(s) dropped, ring buffer full");
+    writer.Write(LogChannel::System, batch);
+    writer.Close();
+
+    auto lines = QueryLogWindow(directory_, kBaseMs, kBaseMs + 10);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[1].timestampMs, kBaseMs + 10);
+}
+
+}  // namespace
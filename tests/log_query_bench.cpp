@@ -0,0 +1,162 @@
+// Event-window query over a generated log folder: the indexed path (FindLogEvents + QueryLogWindow, as used
+// by bwy_logtool query) against scanning the three logs line by line, which is what triage did by hand.
+// Both paths must return the same lines. Usage: log_query_bench [--quick | --megabytes N].
+
+#include "log_corpus.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::int64_t kStartMs = 1700000000000;
+constexpr std::size_t kLinesPerQuestRun = 4000;
+constexpr std::size_t kLinesPerBatch = 40;
+constexpr std::int64_t kWindowBeforeMs = 30000;
+constexpr std::int64_t kWindowAfterMs = 60000;
+
+// Quest runs one after another: a steady stream of action and system lines
+// with the quest banners and stage lines on the quest channel. Returns the
+// number of TRIGGER STAGE REACHED events written.
+std::size_t GenerateCorpus(const std::filesystem::path& directory, std::uint64_t targetBytes) {
+    LogCorpusWriter writer(directory);
+    std::array<LogBatch, kLogChannelCount> batches;
+    std::int64_t timestampMs = kStartMs;
+    std::size_t triggers = 0;
+
+    auto flushFull = [&](LogChannel channel) {
+        LogBatch& batch = batches[static_cast<std::size_t>(channel)];
+        if (batch.lines >= kLinesPerBatch) {
+            writer.Write(channel, batch);
+        }
+    };
+
+    for (std::size_t line = 0; writer.BytesWritten() < targetBytes; ++line) {
+        timestampMs += 50;
+        std::size_t step = line % kLinesPerQuestRun;
+        LogBatch& quest = batches[static_cast<std::size_t>(LogChannel::Quest)];
+
+        if (step == 0) {
+            AppendDeferredLine(quest, LogChannel::Quest, timestampMs, LogFormatId::QuestActivated);
+        } else if (step == kLinesPerQuestRun / 2) {
+            AppendDeferredLine(quest, LogChannel::Quest, timestampMs, LogFormatId::TriggerStageReached);
+            AppendDeferredLine(quest, LogChannel::Quest, timestampMs, LogFormatId::Stage, 40);
+            ++triggers;
+        } else if (step % 16 == 0) {
+            AppendDeferredLine(quest, LogChannel::Quest, timestampMs, LogFormatId::CurrentStage,
+                               static_cast<std::int64_t>(step / 100));
+        }
+
+        if (step % 3 == 0) {
+            AppendTextLine(batches[static_cast<std::size_t>(LogChannel::System)], LogChannel::System, timestampMs,
+                           "Monitor woke 12 times in the last 30000 ms; 3 rules active, next deadline in 250 ms");
+        } else {
+            AppendTextLine(batches[static_cast<std::size_t>(LogChannel::Actions)], LogChannel::Actions, timestampMs,
+                           "Container change: item 0x0A012345 count 1 from container 0x00012E49 to player");
+        }
+
+        for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+            flushFull(static_cast<LogChannel>(i));
+        }
+    }
+
+    for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+        writer.Write(static_cast<LogChannel>(i), batches[i]);
+    }
+    return triggers;
+}
+
+// Without the index: scan the quest log for the banner, then every log for the window.
+std::vector<LogQueryLine> ScanEventWindow(const std::filesystem::path& directory, std::size_t occurrence) {
+    std::int64_t eventMs = 0;
+    {
+        std::ifstream file(directory / GetLogFileName(LogChannel::Quest));
+        std::string line;
+        std::size_t seen = 0;
+        while (std::getline(file, line)) {
+            if (line.ends_with("TRIGGER STAGE REACHED") && seen++ == occurrence) {
+                eventMs = ParseLogTimestamp(std::string_view(line).substr(1)).value_or(0);
+                break;
+            }
+        }
+    }
+
+    std::vector<LogQueryLine> lines;
+    for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+        auto channel = static_cast<LogChannel>(i);
+        std::ifstream file(directory / GetLogFileName(channel));
+        std::string line;
+        std::int64_t timestampMs = 0;
+        while (std::getline(file, line)) {
+            timestampMs = ParseLogTimestamp(std::string_view(line).substr(1)).value_or(timestampMs);
+            if (timestampMs >= eventMs - kWindowBeforeMs && timestampMs <= eventMs + kWindowAfterMs) {
+                lines.push_back({timestampMs, channel, line});
+            }
+        }
+    }
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const LogQueryLine& a, const LogQueryLine& b) { return a.timestampMs < b.timestampMs; });
+    return lines;
+}
+
+std::vector<LogQueryLine> IndexedEventWindow(const std::filesystem::path& directory, std::size_t occurrence) {
+    auto hits = FindLogEvents(directory, LogFormatId::TriggerStageReached);
+    std::int64_t eventMs = hits.at(occurrence).timestampMs;
+    return QueryLogWindow(directory, eventMs - kWindowBeforeMs, eventMs + kWindowAfterMs);
+}
+
+template <class Fn>
+double MeasureMillis(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t megabytes = 300;
+    if (argc > 1 && std::strcmp(argv[1], "--quick") == 0) {
+        megabytes = 4;
+    } else if (argc > 2 && std::strcmp(argv[1], "--megabytes") == 0) {
+        megabytes = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("bwy_query_bench_" + std::to_string(getpid()));
+    std::filesystem::remove_all(directory);
+
+    std::size_t triggers = 0;
+    double generateMs = MeasureMillis([&] { triggers = GenerateCorpus(directory, megabytes * 1024 * 1024); });
+    std::uint64_t logBytes = 0;
+    std::uint64_t indexBytes = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        (entry.path().extension() == ".idx" ? indexBytes : logBytes) += entry.file_size();
+    }
+    std::printf("corpus: %.1f MB of logs, %.1f MB of index, %zu quest runs, generated in %.0f ms\n",
+                static_cast<double>(logBytes) / (1024 * 1024), static_cast<double>(indexBytes) / (1024 * 1024),
+                triggers, generateMs);
+
+    const std::size_t occurrence = triggers / 2;
+    std::vector<LogQueryLine> scanned;
+    std::vector<LogQueryLine> indexed;
+    double scanMs = MeasureMillis([&] { scanned = ScanEventWindow(directory, occurrence); });
+    double indexMs = MeasureMillis([&] { indexed = IndexedEventWindow(directory, occurrence); });
+
+    bool same = scanned.size() == indexed.size();
+    for (std::size_t i = 0; same && i < scanned.size(); ++i) {
+        same = scanned[i].text == indexed[i].text;
+    }
+
+    std::printf("event window (%zu lines): full scan %.1f ms, indexed %.1f ms, %.0fx%s\n", indexed.size(), scanMs,
+                indexMs, scanMs / indexMs, same ? "" : "  MISMATCH");
+
+    std::filesystem::remove_all(directory);
+    return same && !indexed.empty() ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct DrainedRecord {
+    LogRecordKind kind;
+    std::int64_t timestampMs;
+    std::string payload;
+};
+
+std::vector<DrainedRecord> DrainAll(LogRingBuffer& ring) {
+    std::vector<DrainedRecord> records;
+    ring.Drain([&records](LogRecordKind kind, std::int64_t timestampMs, std::string_view payload) {
+        records.push_back({kind, timestampMs, std::string(payload)});
+    });
+    return records;
+}
+
+TEST(LogRingBufferTest, DrainsRecordsInPushOrder) {
+    auto ring = std::make_unique<LogRingBuffer>();
+    ASSERT_TRUE(ring->TryPush(LogRecordKind::Text, 10, "first"));
+    ASSERT_TRUE(ring->TryPush(LogRecordKind::Deferred, 11, std::string_view("\0\1\2", 3)));
+    ASSERT_TRUE(ring->TryPush(LogRecordKind::Text, 12, "third"));
+
+    auto records = DrainAll(*ring);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].payload, "first");
+    EXPECT_EQ(records[0].timestampMs, 10);
+    EXPECT_EQ(records[1].kind, LogRecordKind::Deferred);
+    EXPECT_EQ(records[1].payload.size(), 3u);
+    EXPECT_EQ(records[2].payload, "third");
+    EXPECT_TRUE(DrainAll(*ring).empty());
+}
+
+TEST(LogRingBufferTest, CountsDropsWhenFullAndRecoversAfterDrain) {
+    auto ring = std::make_unique<LogRingBuffer>();
+    for (std::size_t i = 0; i < kLogRingCapacity; ++i) {
+        ASSERT_TRUE(ring->TryPush(LogRecordKind::Text, 0, "x"));
+    }
+    EXPECT_FALSE(ring->TryPush(LogRecordKind::Text, 0, "overflow"));
+    EXPECT_FALSE(ring->TryPush(LogRecordKind::Text, 0, "overflow"));
+    EXPECT_EQ(ring->TakeDroppedCount(), 2u);
+    EXPECT_EQ(ring->TakeDroppedCount(), 0u);
+
+    EXPECT_EQ(DrainAll(*ring).size(), kLogRingCapacity);
+    EXPECT_TRUE(ring->TryPush(LogRecordKind::Text, 0, "after"));
+    auto records = DrainAll(*ring);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].payload, "after");
+}
+
+TEST(LogRingBufferTest, TruncatesOversizedRecords) {
+    auto ring = std::make_unique<LogRingBuffer>();
+    std::string longLine(kLogRecordTextSize + 50, 'a');
+    ASSERT_TRUE(ring->TryPush(LogRecordKind::Text, 0, longLine));
+    auto records = DrainAll(*ring);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].payload.size(), kLogRecordTextSize);
+}
+
+// Producers push concurrently while a consumer drains; every record arrives exactly once and each
+// producer's records keep their order.
+TEST(LogRingBufferTest, ConcurrentProducersWithLiveDrain) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+
+    auto ring = std::make_unique<LogRingBuffer>();
+    std::atomic<int> finished{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, &finished, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                std::string text = std::to_string(p) + ":" + std::to_string(i);
+                while (!ring->TryPush(LogRecordKind::Text, p, text)) {
+                    std::this_thread::yield();
+                }
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    std::size_t total = 0;
+    bool ordered = true;
+    auto consume = [&](LogRecordKind, std::int64_t producer, std::string_view payload) {
+        auto colon = payload.find(':');
+        int index = std::stoi(std::string(payload.substr(colon + 1)));
+        ordered = ordered && index == next[producer];
+        next[producer] = index + 1;
+        ++total;
+    };
+    while (finished.load() < kProducers) {
+        ring->Drain(consume);
+    }
+    ring->Drain(consume);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(total, static_cast<std::size_t>(kProducers * kPerProducer));
+}
+
+}  // namespace
@@ -0,0 +1,212 @@
+// Wake-count harness for the monitor thread, on a fake clock. Each simulated hour loads a save (a 20 s loading
+// screen, then the 5 s initial delay), and one rule's quest starts at :20, reaches its trigger stage at :21 and
+// gets its item at :23, which arms a 10 s completion delay. The former loop slept CheckIntervalMs between
+// passes and 100 ms during loading screens and the initial delay; the current one waits for
+// NextMonitorDeadline or a wake from an event. Wakeups are counted while a rule is in progress, while nothing
+// is, and for events. Pass --quick for one hour or --hours N.
+
+#include "PluginCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kInterval = 1000ms;   // CheckIntervalMs default
+constexpr auto kPausedPoll = 100ms;  // the former loop's sleep during transitions and the initial delay
+constexpr auto kLoadingScreen = 20s;
+constexpr auto kInitialDelay = 5s;
+constexpr auto kCompletionDelay = 10s;
+
+enum class Step { LoadStart, LoadEnd, QuestStart, TriggerStage, ItemAdded, None };
+
+// The scripted event at or after offset into an hour.
+struct ScriptEvent {
+    Clock::duration at;
+    Step step;
+};
+
+constexpr ScriptEvent kScript[] = {{0s, Step::LoadStart},
+                                   {kLoadingScreen, Step::LoadEnd},
+                                   {20min, Step::QuestStart},
+                                   {21min, Step::TriggerStage},
+                                   {23min, Step::ItemAdded}};
+
+struct WakeCounts {
+    std::uint64_t active = 0;  // a rule in progress, or the monitor paused for a load
+    std::uint64_t idle = 0;    // nothing to do
+    std::uint64_t events = 0;  // woken by an event sink or a session start
+    std::uint64_t Total() const { return active + idle + events; }
+};
+
+// Rule and session state shared by both loops, driven by the script.
+class Session {
+public:
+    Clock::time_point origin{std::chrono::hours(1000)};
+    std::uint32_t generation = 1;
+    FixRulePhaseWords phases{1};
+    bool loading = false;
+    Clock::time_point initialDelayEnd{};
+
+    bool Paused(Clock::time_point now) const { return loading || now < initialDelayEnd; }
+
+    // The wake that ends the initial delay starts monitoring, so it is not idle either.
+    bool Busy(Clock::time_point now) const {
+        FixRulePhase phase = phases.Load(0, generation);
+        return loading || now <= initialDelayEnd || (phase != FixRulePhase::Idle && phase != FixRulePhase::Done);
+    }
+
+    // Applies a scripted step; returns true when it arms the completion delay.
+    bool Apply(Step step, Clock::time_point now) {
+        switch (step) {
+            case Step::LoadStart:
+                loading = true;
+                ++generation;
+                return false;
+            case Step::LoadEnd:
+                loading = false;
+                initialDelayEnd = now + kInitialDelay;
+                return false;
+            case Step::QuestStart:
+                phases.Transition(0, FixRulePhase::Idle, FixRulePhase::Active, generation);
+                return false;
+            case Step::TriggerStage:
+                phases.Transition(0, FixRulePhase::Active, FixRulePhase::Triggered, generation);
+                return false;
+            case Step::ItemAdded:
+                return phases.Transition(0, FixRulePhase::Triggered, FixRulePhase::ItemDetected, generation);
+            case Step::None:
+                break;
+        }
+        return false;
+    }
+
+    void Complete() {
+        phases.Transition(0, FixRulePhase::ItemDetected, FixRulePhase::Completing, generation);
+        phases.Transition(0, FixRulePhase::Completing, FixRulePhase::Done, generation);
+    }
+};
+
+// The next scripted event strictly after now.
+ScriptEvent NextEvent(const Session& session, Clock::time_point now) {
+    auto offset = now - session.origin;
+    auto hour = std::chrono::floor<std::chrono::hours>(offset);
+    for (int next = 0; next < 2; ++next) {
+        for (const ScriptEvent& event : kScript) {
+            if (hour + std::chrono::hours(next) + event.at > offset) {
+                return {hour + std::chrono::hours(next) + event.at, event.step};
+            }
+        }
+    }
+    return {Clock::duration::max(), Step::None};
+}
+
+WakeCounts RunPollingLoop(std::chrono::hours hours) {
+    Session session;
+    const Clock::time_point end = session.origin + hours;
+    bool completing = false;
+    Clock::time_point completeAt{};
+    Clock::time_point now = session.origin;
+    ScriptEvent next = NextEvent(session, now - 1ns);
+    WakeCounts wakes;
+
+    while (now < end) {
+        now += session.Paused(now) ? kPausedPoll : kInterval;
+        bool busy = session.Busy(now);
+        while (session.origin + next.at <= now) {
+            if (session.Apply(next.step, session.origin + next.at)) {
+                completing = true;
+                completeAt = session.origin + next.at + kCompletionDelay;
+            }
+            next = NextEvent(session, session.origin + next.at);
+        }
+        if (completing && now >= completeAt) {
+            session.Complete();
+            completing = false;
+        }
+        ++(busy ? wakes.active : wakes.idle);
+    }
+    return wakes;
+}
+
+WakeCounts RunDeadlineLoop(std::chrono::hours hours) {
+    Session session;
+    const Clock::time_point end = session.origin + hours;
+    TimerWheel wheel(session.origin);
+    Clock::time_point now = session.origin;
+    Clock::time_point lastPoll = now;
+    ScriptEvent next = NextEvent(session, now - 1ns);
+    WakeCounts wakes;
+
+    while (true) {
+        std::optional<Clock::time_point> deadline;
+        if (!session.loading) {
+            deadline = now < session.initialDelayEnd
+                           ? wheel.NextDeadline()
+                           : NextMonitorDeadline(session.phases, 1, session.generation, lastPoll, kInterval,
+                                                 wheel.NextDeadline());
+        }
+        const Clock::time_point eventAt = session.origin + next.at;
+        now = deadline ? (std::min)(*deadline, eventAt) : eventAt;
+        if (now >= end) {
+            break;
+        }
+
+        // One wake handles the event and whatever else is due at that moment.
+        if (eventAt == now) {
+            ++wakes.events;
+            if (next.step == Step::LoadEnd) {
+                session.Apply(next.step, now);
+                wheel.ScheduleAt(session.initialDelayEnd, kTimerAnySession, [&lastPoll, &now] { lastPoll = now; });
+            } else if (session.Apply(next.step, now)) {
+                wheel.ScheduleAt(now + kCompletionDelay, session.generation, [&session] { session.Complete(); });
+            }
+            next = NextEvent(session, now);
+        } else {
+            ++(session.Busy(now) ? wakes.active : wakes.idle);
+        }
+
+        wheel.Advance(now, session.generation);
+        if (!session.Paused(now) && now - lastPoll >= kInterval) {
+            lastPoll = now;
+        }
+    }
+    return wakes;
+}
+
+void Report(const char* name, const WakeCounts& wakes, std::chrono::hours hours) {
+    const double minutes = std::chrono::duration<double, std::ratio<60>>(hours).count();
+    std::printf("%-20s %9llu wakeups  %8.1f/min  (in progress %llu, idle %llu = %.1f/min, events %llu)\n", name,
+                static_cast<unsigned long long>(wakes.Total()), wakes.Total() / minutes,
+                static_cast<unsigned long long>(wakes.active), static_cast<unsigned long long>(wakes.idle),
+                wakes.idle / minutes, static_cast<unsigned long long>(wakes.events));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::chrono::hours hours(24);
+    if (argc > 1 && std::strcmp(argv[1], "--quick") == 0) {
+        hours = std::chrono::hours(1);
+    } else if (argc > 2 && std::strcmp(argv[1], "--hours") == 0) {
+        hours = std::chrono::hours(std::strtol(argv[2], nullptr, 10));
+    }
+
+    WakeCounts polling = RunPollingLoop(hours);
+    WakeCounts deadline = RunDeadlineLoop(hours);
+
+    std::printf("%lld simulated hour(s), one save load and one rule run per hour\n",
+                static_cast<long long>(hours.count()));
+    Report("polling", polling, hours);
+    Report("deadline + wakes", deadline, hours);
+
+    // Idle, the waiting loop must not wake at all.
+    return deadline.idle == 0 && deadline.Total() < polling.Total() ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Per-event cost of the fix rule engine against the number of rules. Each synthetic rule watches its own quest
+// and two items; the event stream is the game's, where almost every quest stage and container change belongs
+// to something no rule watches. The indexed dispatch used by the event sinks should stay flat as rules are
+// added, while the linear scan it replaced grows with them.
+
+#include "PluginCore.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kSession = 7;
+constexpr std::size_t kEventCount = 4096;
+
+struct SyntheticRules {
+    std::vector<std::uint32_t> questFormIDs;
+    std::vector<std::int32_t> triggerStages;
+    std::vector<std::uint32_t> itemOffsets;
+    std::vector<std::uint32_t> itemFormIDs;
+    FormIDIndex rulesByQuest;
+    FormIDIndex rulesByItem;
+    std::unique_ptr<FixRulePhaseWords> phases;
+    std::vector<std::uint32_t> events;  // one in 64 hits a watched quest or item
+
+    explicit SyntheticRules(std::uint32_t count) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> questEntries;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> itemEntries;
+        phases = std::make_unique<FixRulePhaseWords>(count);
+        for (std::uint32_t rule = 0; rule < count; ++rule) {
+            std::uint32_t plugin = (0x05u + rule / 64) << 24;
+            questFormIDs.push_back(plugin | (0x1000 + rule));
+            triggerStages.push_back(20);
+            itemOffsets.push_back(static_cast<std::uint32_t>(itemFormIDs.size()));
+            itemFormIDs.push_back(plugin | (0x8000 + rule * 2));
+            itemFormIDs.push_back(plugin | (0x8001 + rule * 2));
+            questEntries.emplace_back(questFormIDs.back(), rule);
+            itemEntries.emplace_back(itemFormIDs[itemFormIDs.size() - 2], rule);
+            itemEntries.emplace_back(itemFormIDs.back(), rule);
+            phases->Store(rule, rule % 3 == 0 ? FixRulePhase::Done : FixRulePhase::Active, kSession);
+        }
+        itemOffsets.push_back(static_cast<std::uint32_t>(itemFormIDs.size()));
+        rulesByQuest.Build(std::move(questEntries));
+        rulesByItem.Build(std::move(itemEntries));
+
+        std::mt19937 random(count);
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            if (random() % 64 == 0) {
+                events.push_back(random() % 2 ? questFormIDs[random() % count] : itemFormIDs[random() % (2 * count)]);
+            } else {
+                events.push_back(0x01000000u | (random() & 0xFFFFF));
+            }
+        }
+    }
+};
+
+// QuestStageEventSink/ContainerChangeEventSink: one index probe, then only the rules that watch the form.
+std::size_t DispatchIndexed(const SyntheticRules& rules, std::uint32_t formID) {
+    std::size_t live = 0;
+    for (std::uint32_t rule : rules.rulesByQuest.Find(formID)) {
+        live += rules.phases->Load(rule, kSession) != FixRulePhase::Done;
+    }
+    for (std::uint32_t rule : rules.rulesByItem.Find(formID)) {
+        live += rules.phases->Load(rule, kSession) != FixRulePhase::Done;
+    }
+    return live;
+}
+
+// Before: every rule compared against every event.
+std::size_t DispatchLinear(const SyntheticRules& rules, std::uint32_t formID) {
+    std::size_t live = 0;
+    for (std::uint32_t rule = 0; rule < rules.questFormIDs.size(); ++rule) {
+        bool watches = rules.questFormIDs[rule] == formID;
+        for (std::uint32_t i = rules.itemOffsets[rule]; i < rules.itemOffsets[rule + 1]; ++i) {
+            watches |= rules.itemFormIDs[i] == formID;
+        }
+        live += watches && rules.phases->Load(rule, kSession) != FixRulePhase::Done;
+    }
+    return live;
+}
+
+template <std::size_t (*Dispatch)(const SyntheticRules&, std::uint32_t)>
+void BM_Dispatch(benchmark::State& state) {
+    SyntheticRules rules(static_cast<std::uint32_t>(state.range(0)));
+    std::size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Dispatch(rules, rules.events[next]));
+        next = (next + 1) % kEventCount;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Dispatch, DispatchIndexed)->RangeMultiplier(4)->Range(1, 1024);
+BENCHMARK_TEMPLATE(BM_Dispatch, DispatchLinear)->RangeMultiplier(4)->Range(1, 1024);
+
+// Rebuilding both indexes, which happens once per rule table publish.
+void BM_BuildIndexes(benchmark::State& state) {
+    SyntheticRules rules(static_cast<std::uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+        for (std::uint32_t rule = 0; rule < rules.questFormIDs.size(); ++rule) {
+            entries.emplace_back(rules.questFormIDs[rule], rule);
+        }
+        FormIDIndex index;
+        index.Build(std::move(entries));
+        benchmark::DoNotOptimize(index);
+    }
+}
+BENCHMARK(BM_BuildIndexes)->RangeMultiplier(4)->Range(1, 1024);
+
+}  // namespace
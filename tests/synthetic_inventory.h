@@ -0,0 +1,95 @@
+#pragma once
+
+// A player inventory laid out like the engine's: a small array of base container objects reached through
+// pointers, and an InventoryChanges entry list of separately allocated nodes. The watched-item tests and the
+// inventory benchmarks scan it the way the plugin scans the real one, and materialize it the way
+// TESObjectREFR::GetInventory() does.
+
+#include "PluginCore.h"
+
+#include <array>
+#include <forward_list>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct SyntheticContainerObject {
+    std::uint32_t formID;
+    std::int32_t count;
+};
+
+// Stands in for InventoryEntryData: the object, its delta and the extra-data lists GetInventory() copies.
+struct SyntheticChangeEntry {
+    std::uint32_t formID;
+    std::int32_t countDelta;
+    std::array<std::uint64_t, 3> extraLists{};
+};
+
+struct SyntheticInventory {
+    std::vector<std::unique_ptr<SyntheticContainerObject>> base;
+    std::forward_list<SyntheticChangeEntry> changes;
+    std::vector<std::uint32_t> watched;
+};
+
+// entries change-list nodes plus a base container a tenth that size. The first watched items are spread
+// through the change list and the base container; any beyond that are watched but not carried.
+inline SyntheticInventory MakeSyntheticInventory(std::size_t entries, std::size_t watched, std::size_t carried,
+                                                 std::uint32_t seed = 7) {
+    std::mt19937 random(seed);
+    SyntheticInventory inventory;
+    for (std::size_t i = 0; i < watched; ++i) {
+        inventory.watched.push_back(0x0A000800u + static_cast<std::uint32_t>(i));
+    }
+
+    std::vector<SyntheticChangeEntry> changes;
+    for (std::size_t i = 0; i < entries; ++i) {
+        changes.push_back({0x00010000u + static_cast<std::uint32_t>(i), static_cast<std::int32_t>(random() % 5 + 1)});
+    }
+    for (std::size_t i = 0; i < std::min(carried, watched) && !changes.empty(); ++i) {
+        changes[random() % changes.size()].formID = inventory.watched[i];
+    }
+    for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+        inventory.changes.push_front(*it);
+    }
+
+    for (std::size_t i = 0; i < entries / 10; ++i) {
+        std::uint32_t formID = 0x00010000u + static_cast<std::uint32_t>(random() % (entries + 1));
+        if (i < std::min(carried, watched) && i % 2 == 0) {
+            formID = inventory.watched[i];
+        }
+        inventory.base.push_back(std::make_unique<SyntheticContainerObject>(SyntheticContainerObject{formID, 1}));
+    }
+    return inventory;
+}
+
+// What GetInventory() builds: one map node and one copied entry per distinct object.
+using MaterializedInventory = std::map<std::uint32_t, std::pair<std::int32_t, std::unique_ptr<SyntheticChangeEntry>>>;
+
+inline MaterializedInventory MaterializeInventory(const SyntheticInventory& inventory) {
+    MaterializedInventory items;
+    for (const auto& object : inventory.base) {
+        auto& item = items[object->formID];
+        item.first += object->count;
+    }
+    for (const auto& entry : inventory.changes) {
+        auto& item = items[entry.formID];
+        item.first += entry.countDelta;
+        item.second = std::make_unique<SyntheticChangeEntry>(entry);
+    }
+    return items;
+}
+
+// The walk ScanPlayerInventory does over the live lists.
+inline std::size_t ScanInventory(const WatchedItemCounts& counts, const SyntheticInventory& inventory) {
+    counts.BeginScan();
+    for (const auto& object : inventory.base) {
+        counts.AddBase(object->formID, object->count);
+    }
+    for (const auto& entry : inventory.changes) {
+        if (counts.AddChange(entry.formID, entry.countDelta)) {
+            break;
+        }
+    }
+    return counts.CommitScan();
+}
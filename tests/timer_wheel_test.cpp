@@ -0,0 +1,162 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = TimerWheel::Clock;
+
+// A clock that only moves when told to; every wheel in these tests starts at its origin.
+class FakeClock {
+public:
+    Clock::time_point Now() const { return now_; }
+    void Advance(Clock::duration step) { now_ += step; }
+
+private:
+    Clock::time_point now_{std::chrono::hours(1000)};
+};
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    FakeClock clock_;
+    TimerWheel wheel_{clock_.Now()};
+
+    TimerHandle After(Clock::duration delay, std::vector<int>& fired, int id,
+                      std::uint32_t generation = kTimerAnySession) {
+        return wheel_.ScheduleAt(clock_.Now() + delay, generation, [&fired, id] { fired.push_back(id); });
+    }
+
+    std::size_t Step(Clock::duration step, std::uint32_t generation = 1) {
+        clock_.Advance(step);
+        return wheel_.Advance(clock_.Now(), generation);
+    }
+};
+
+TEST_F(TimerWheelTest, RunsTimersInDeadlineOrderAndNeverEarly) {
+    std::vector<int> fired;
+    After(35ms, fired, 3);
+    After(15ms, fired, 1);
+    After(25ms, fired, 2);
+
+    Step(10ms);
+    EXPECT_TRUE(fired.empty());
+    Step(10ms);
+    EXPECT_EQ(fired, (std::vector<int>{1}));
+    Step(30ms);
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+    EXPECT_FALSE(wheel_.NextDeadline());
+}
+
+TEST_F(TimerWheelTest, CancelledAndReusedHandlesNeverFire) {
+    std::vector<int> fired;
+    TimerHandle first = After(50ms, fired, 1);
+    EXPECT_TRUE(wheel_.Cancel(first));
+    EXPECT_FALSE(wheel_.Cancel(first));
+
+    // The node is pooled and handed out again; the old handle must not cancel the new timer.
+    TimerHandle second = After(50ms, fired, 2);
+    EXPECT_EQ(second.node, first.node);
+    EXPECT_FALSE(wheel_.Cancel(first));
+    EXPECT_FALSE(wheel_.Cancel(TimerHandle{}));
+
+    Step(60ms);
+    EXPECT_EQ(fired, (std::vector<int>{2}));
+    EXPECT_FALSE(wheel_.Cancel(second));
+}
+
+TEST_F(TimerWheelTest, DropsTimersFromAnotherSession) {
+    std::vector<int> fired;
+    After(20ms, fired, 1, 1);
+    After(20ms, fired, 2, 2);
+    After(20ms, fired, 3, kTimerAnySession);
+    After(2h, fired, 4, 1);
+
+    EXPECT_EQ(Step(30ms, 2), 1u);
+    std::sort(fired.begin(), fired.end());  // timers due in the same tick run in no particular order
+    EXPECT_EQ(fired, (std::vector<int>{2, 3}));
+    EXPECT_EQ(Step(3h, 2), 1u);
+    EXPECT_EQ(fired, (std::vector<int>{2, 3}));
+}
+
+TEST_F(TimerWheelTest, NextDeadlineIsTheEarliestArmedTimer) {
+    std::vector<int> fired;
+    EXPECT_FALSE(wheel_.NextDeadline());
+    After(90min, fired, 1);
+    After(5s, fired, 2);
+    After(700ms, fired, 3);
+    EXPECT_EQ(wheel_.NextDeadline(), clock_.Now() + 700ms);
+
+    Step(1s);
+    EXPECT_EQ(wheel_.NextDeadline(), clock_.Now() + 4s);
+    Step(4s);
+    EXPECT_EQ(wheel_.NextDeadline(), clock_.Now() + 90min - 5s);
+}
+
+// Ten days is several times the wheel's reach; the timer waits in the overflow list across each wrap.
+TEST_F(TimerWheelTest, KeepsTimersBeyondTheHorizonUntilTheirTick) {
+    std::vector<int> fired;
+    const Clock::time_point deadline = clock_.Now() + 24h * 10;
+    After(24h * 10, fired, 1);
+    TimerHandle cancelled = After(24h * 5, fired, 2);
+    After(1h, fired, 3);
+
+    Step(47h);
+    EXPECT_EQ(fired, (std::vector<int>{3}));
+    EXPECT_TRUE(wheel_.Cancel(cancelled));
+    EXPECT_EQ(wheel_.NextDeadline(), deadline);
+
+    Step(deadline - clock_.Now() - 10ms);
+    EXPECT_EQ(fired, (std::vector<int>{3}));
+    Step(10ms);
+    EXPECT_EQ(fired, (std::vector<int>{3, 1}));
+    EXPECT_EQ(wheel_.NextDeadline(), std::nullopt);
+}
+
+// Thousands of timers across every level, a third cancelled, advanced in uneven steps: each survivor runs
+// exactly once, in its own tick or the first Advance after it, and never before its deadline.
+TEST_F(TimerWheelTest, ThousandsOfTimersFireOnceAtTheirTick) {
+    constexpr int kTimers = 20000;
+    std::mt19937 random(99);
+    std::vector<Clock::time_point> deadlines(kTimers);
+    std::vector<Clock::time_point> firedAt(kTimers);
+    std::vector<int> runs(kTimers, 0);
+    std::vector<TimerHandle> handles(kTimers);
+
+    for (int i = 0; i < kTimers; ++i) {
+        auto delay = std::chrono::milliseconds(random() % (i % 4 == 0 ? 3'600'000 : 60'000));
+        deadlines[i] = clock_.Now() + delay;
+        handles[i] = wheel_.ScheduleAt(deadlines[i], kTimerAnySession, [this, i, &runs, &firedAt] {
+            ++runs[i];
+            firedAt[i] = clock_.Now();
+        });
+    }
+    for (int i = 0; i < kTimers; i += 3) {
+        ASSERT_TRUE(wheel_.Cancel(handles[i]));
+    }
+
+    Clock::time_point end = clock_.Now() + 2h;
+    while (clock_.Now() < end) {
+        Clock::duration step = std::chrono::milliseconds(random() % 3 == 0 ? random() % 5000 : random() % 40 + 1);
+        Step(step);
+        if (auto next = wheel_.NextDeadline()) {
+            ASSERT_GT(*next, clock_.Now() - TimerWheel::kTick);
+        }
+    }
+
+    for (int i = 0; i < kTimers; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_EQ(runs[i], 0) << i;
+            continue;
+        }
+        ASSERT_EQ(runs[i], 1) << i;
+        EXPECT_GE(firedAt[i], deadlines[i]) << i;
+    }
+    EXPECT_FALSE(wheel_.NextDeadline());
+}
+
+}  // namespace
@@ -0,0 +1,59 @@
+#include "PluginCore.h"
+
+#include <benchmark/benchmark.h>
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// The per-line formatter every log channel used before the cached prefix.
+std::string FormatTimestampWithStringStream(std::chrono::system_clock::time_point now) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    std::time_t time_t = std::chrono::system_clock::to_time_t(now);
+    std::tm buf;
+    localtime_r(&time_t, &buf);
+    std::stringstream ss;
+    ss << std::put_time(&buf, "%Y-%m-%d %H:%M:%S");
+    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
+    return ss.str();
+}
+
+// A burst of quest-stage lines: many lines within the same second, 1 ms apart.
+std::chrono::system_clock::time_point BurstTime(std::int64_t line) {
+    static const auto start = std::chrono::system_clock::now();
+    return start + std::chrono::milliseconds(line % 1000);
+}
+
+void BM_StringStreamTimestamp(benchmark::State& state) {
+    std::int64_t line = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FormatTimestampWithStringStream(BurstTime(line++)));
+    }
+}
+BENCHMARK(BM_StringStreamTimestamp);
+
+void BM_CachedPrefixTimestamp(benchmark::State& state) {
+    std::int64_t line = 0;
+    char buffer[kTimestampLength];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FormatTimestamp(BurstTime(line++), buffer));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_CachedPrefixTimestamp);
+
+// Every line in a new second, so the prefix is rebuilt each time.
+void BM_CachedPrefixTimestampColdSecond(benchmark::State& state) {
+    auto time = std::chrono::system_clock::now();
+    char buffer[kTimestampLength];
+    for (auto _ : state) {
+        time += std::chrono::seconds(1);
+        benchmark::DoNotOptimize(FormatTimestamp(time, buffer));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_CachedPrefixTimestampColdSecond);
+
+}  // namespace
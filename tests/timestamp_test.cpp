@@ -0,0 +1,33 @@
+#include "PluginCore.h"
+
+#include <gtest/gtest.h>
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::string Reference(std::chrono::system_clock::time_point time) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) % 1000;
+    std::time_t time_t = std::chrono::system_clock::to_time_t(time);
+    std::tm buf;
+    localtime_r(&time_t, &buf);
+    std::ostringstream ss;
+    ss << std::put_time(&buf, "%Y-%m-%d %H:%M:%S") << "." << std::setfill('0') << std::setw(3) << ms.count();
+    return ss.str();
+}
+
+// Walks across second boundaries so both the cached and the rebuilt prefix are checked.
+TEST(TimestampTest, MatchesPutTimeAcrossSeconds) {
+    auto time = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+    char buffer[kTimestampLength];
+    for (int step = 0; step < 3000; step += 7) {
+        auto at = time + std::chrono::milliseconds(step);
+        char* end = FormatTimestamp(at, buffer);
+        ASSERT_EQ(end - buffer, static_cast<std::ptrdiff_t>(kTimestampLength));
+        ASSERT_EQ(std::string(buffer, kTimestampLength), Reference(at)) << "step " << step;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,66 @@
+#include "synthetic_inventory.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(WatchedItemCountsTest, AppliesDeltasOnlyToWatchedItems) {
+    WatchedItemCounts counts({0x0A000800, 0x0A000801, 0x0A000800});
+    EXPECT_TRUE(counts.Apply(0x0A000800, 3));
+    EXPECT_TRUE(counts.Apply(0x0A000800, -1));
+    EXPECT_FALSE(counts.Apply(0x00012345, 1));
+    EXPECT_EQ(counts.Count(0x0A000800), 2);
+    EXPECT_EQ(counts.Count(0x0A000801), 0);
+    EXPECT_EQ(counts.Count(0x00012345), 0);
+}
+
+TEST(WatchedItemCountsTest, ScanMatchesTheMaterializedInventory) {
+    for (std::size_t entries : {0u, 100u, 1000u, 10000u}) {
+        SyntheticInventory inventory = MakeSyntheticInventory(entries, 24, 16);
+        WatchedItemCounts counts(inventory.watched);
+        ScanInventory(counts, inventory);
+
+        MaterializedInventory items = MaterializeInventory(inventory);
+        for (std::uint32_t item : inventory.watched) {
+            auto it = items.find(item);
+            EXPECT_EQ(counts.Count(item), it != items.end() ? it->second.first : 0) << entries << " " << item;
+        }
+    }
+}
+
+TEST(WatchedItemCountsTest, ScanReportsDriftAndClampsNegativeTotals) {
+    SyntheticInventory inventory;
+    inventory.watched = {0x0A000800, 0x0A000801, 0x0A000802};
+    inventory.base.push_back(std::make_unique<SyntheticContainerObject>(SyntheticContainerObject{0x0A000800, 2}));
+    inventory.changes.push_front({0x0A000801, -4});
+    inventory.changes.push_front({0x0A000800, 1});
+
+    WatchedItemCounts counts(inventory.watched);
+    EXPECT_EQ(ScanInventory(counts, inventory), 1u);
+    EXPECT_EQ(counts.Count(0x0A000800), 3);
+    EXPECT_EQ(counts.Count(0x0A000801), 0);
+
+    EXPECT_EQ(ScanInventory(counts, inventory), 0u);
+    counts.Apply(0x0A000802, 5);
+    counts.Apply(0x0A000800, -1);
+    EXPECT_EQ(ScanInventory(counts, inventory), 2u);
+    EXPECT_EQ(counts.Count(0x0A000800), 3);
+    EXPECT_EQ(counts.Count(0x0A000802), 0);
+}
+
+TEST(WatchedItemCountsTest, ChangeWalkStopsOnceEveryWatchedItemIsSeen) {
+    WatchedItemCounts counts({0x0A000800, 0x0A000801});
+    counts.BeginScan();
+    EXPECT_FALSE(counts.AddChange(0x00010000, 1));
+    EXPECT_FALSE(counts.AddChange(0x0A000800, 1));
+    EXPECT_FALSE(counts.AddChange(0x00010001, 1));
+    EXPECT_TRUE(counts.AddChange(0x0A000801, 2));
+    counts.CommitScan();
+    EXPECT_EQ(counts.Count(0x0A000801), 2);
+
+    WatchedItemCounts empty({});
+    empty.BeginScan();
+    EXPECT_EQ(empty.CommitScan(), 0u);
+}
+
+}  // namespace
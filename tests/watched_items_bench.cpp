@@ -0,0 +1,54 @@
+#include "synthetic_inventory.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// The former PlayerHasItem: materialize the whole inventory on every poll to look up one item.
+void BM_HasItemThroughGetInventory(benchmark::State& state) {
+    SyntheticInventory inventory = MakeSyntheticInventory(static_cast<std::size_t>(state.range(0)), 8, 8);
+    std::size_t next = 0;
+    for (auto _ : state) {
+        MaterializedInventory items = MaterializeInventory(inventory);
+        auto it = items.find(inventory.watched[next++ % inventory.watched.size()]);
+        benchmark::DoNotOptimize(it != items.end() && it->second.first > 0);
+    }
+}
+BENCHMARK(BM_HasItemThroughGetInventory)->Arg(1000)->Arg(10000)->Arg(50000);
+
+// The count table answers the same question whatever the inventory size.
+void BM_HasItemThroughCounts(benchmark::State& state) {
+    SyntheticInventory inventory = MakeSyntheticInventory(static_cast<std::size_t>(state.range(0)), 8, 8);
+    WatchedItemCounts counts(inventory.watched);
+    ScanInventory(counts, inventory);
+    std::size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(counts.Count(inventory.watched[next++ % inventory.watched.size()]) > 0);
+    }
+}
+BENCHMARK(BM_HasItemThroughCounts)->Arg(1000)->Arg(10000)->Arg(50000);
+
+// One container event delta, alternating watched and unwatched objects.
+void BM_ApplyContainerDelta(benchmark::State& state) {
+    SyntheticInventory inventory = MakeSyntheticInventory(1000, 8, 8);
+    WatchedItemCounts counts(inventory.watched);
+    std::uint32_t next = 0;
+    for (auto _ : state) {
+        std::uint32_t item = next % 2 ? inventory.watched[next % 8] : 0x00010000u + next;
+        benchmark::DoNotOptimize(counts.Apply(item, next % 3 ? 1 : -1));
+        ++next;
+    }
+}
+BENCHMARK(BM_ApplyContainerDelta);
+
+// The low-frequency reconcile that keeps the counts honest.
+void BM_ReconcileLargeInventory(benchmark::State& state) {
+    SyntheticInventory inventory = MakeSyntheticInventory(static_cast<std::size_t>(state.range(0)), 8, 8);
+    WatchedItemCounts counts(inventory.watched);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ScanInventory(counts, inventory));
+    }
+}
+BENCHMARK(BM_ReconcileLargeInventory)->Arg(1000)->Arg(10000)->Arg(50000);
+
+}  // namespace
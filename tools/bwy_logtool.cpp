@@ -0,0 +1,180 @@
+// Command-line reader for the files the plugin leaves in its log folder.
+//
+//   bwy_logtool flight <channel>.flight
+//       Prints every record still held by a flight recorder file, oldest first,
+//       and reports on stderr whether the session that wrote it crashed.
+//
+//   bwy_logtool decode <channel>.blog
+//       Renders a binary deferred log (Logging BinaryLog=true) into the same
+//       text lines the plugin would have written.
+//
+//   bwy_logtool query <log folder> --from <time> --to <time>
+//   bwy_logtool query <log folder> --event <name> [--before <seconds>] [--after <seconds>]
+//       Merges the three channels by time using the sidecar indexes. Times are
+//       local "YYYY-MM-DD HH:MM:SS[.mmm]"; events are activated, stage-event,
+//       trigger, item-added and item-detected, and each occurrence prints the
+//       window around it (30 s before, 60 s after by default).
+
+#include "PluginCore.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+// Recorder files are named after the channel's log file, which also decides
+// the tag deferred records are rendered with.
+LogChannel GetChannelForFile(const std::filesystem::path& path) {
+    for (std::size_t i = 0; i < kLogChannelCount; ++i) {
+        auto channel = static_cast<LogChannel>(i);
+        if (std::filesystem::path(GetLogFileName(channel)).stem() == path.stem()) {
+            return channel;
+        }
+    }
+    return LogChannel::System;
+}
+
+int RunFlight(const std::filesystem::path& path) {
+    std::optional<FlightRecorderHeader> header = FlightRecorder::ReadHeader(path);
+    if (!header) {
+        std::cerr << path.string() << ": not a flight recorder file\n";
+        return 1;
+    }
+
+    std::cerr << path.string() << ": " << header->nextSequence << " records, " << header->persistedSequence
+              << " persisted, "
+              << (header->cleanShutdown != 0                      ? "clean shutdown"
+                  : FlightRecorder::LeftUnflushedRecords(*header) ? "crashed with unflushed records"
+                                                                  : "all records flushed")
+              << '\n';
+
+    for (const auto& line : FlightRecorder::ReadTail(path, GetChannelForFile(path))) {
+        std::cout << line << '\n';
+    }
+    return 0;
+}
+
+int RunDecode(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << path.string() << ": cannot open\n";
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    char line[kLogRecordTextSize];
+    bool complete = DecodeBinaryLog(data, [&line](LogChannel channel, const DeferredLogRecord& record) {
+        std::cout.write(line, static_cast<std::streamsize>(RenderDeferredLogLine(line, channel, record)));
+        std::cout << '\n';
+    });
+    if (!complete) {
+        std::cerr << path.string() << ": not a binary log, or cut off after the records shown\n";
+        return 1;
+    }
+    return 0;
+}
+
+constexpr std::pair<std::string_view, LogFormatId> kQueryEvents[] = {
+    {"activated", LogFormatId::QuestActivated},
+    {"stage-event", LogFormatId::QuestStageEventReceived},
+    {"trigger", LogFormatId::TriggerStageReached},
+    {"item-added", LogFormatId::ContainerItemAdded},
+    {"item-detected", LogFormatId::ItemDetected},
+};
+
+void PrintTimestamp(std::int64_t timestampMs) {
+    char text[kTimestampLength];
+    FormatTimestamp(std::chrono::system_clock::time_point{std::chrono::milliseconds(timestampMs)}, text);
+    std::cout.write(text, kTimestampLength);
+}
+
+void PrintWindow(const std::filesystem::path& directory, std::int64_t fromMs, std::int64_t toMs) {
+    for (const auto& line : QueryLogWindow(directory, fromMs, toMs)) {
+        std::cout << line.text << '\n';
+    }
+}
+
+int RunQuery(const std::filesystem::path& directory, int argc, char** argv) {
+    std::optional<std::int64_t> fromMs;
+    std::optional<std::int64_t> toMs;
+    std::optional<LogFormatId> event;
+    std::int64_t beforeMs = 30000;
+    std::int64_t afterMs = 60000;
+
+    if (argc % 2 != 0) {
+        std::cerr << "missing value for " << argv[argc - 1] << '\n';
+        return 2;
+    }
+    for (int i = 0; i + 1 < argc; i += 2) {
+        std::string_view option = argv[i];
+        std::string_view value = argv[i + 1];
+        if (option == "--from") {
+            fromMs = ParseLogTimestamp(value);
+        } else if (option == "--to") {
+            toMs = ParseLogTimestamp(value);
+        } else if (option == "--before") {
+            beforeMs = std::atoll(argv[i + 1]) * 1000;
+        } else if (option == "--after") {
+            afterMs = std::atoll(argv[i + 1]) * 1000;
+        } else if (option == "--event") {
+            for (const auto& [name, format] : kQueryEvents) {
+                if (name == value) {
+                    event = format;
+                }
+            }
+            if (!event) {
+                std::cerr << "unknown event: " << value << '\n';
+                return 2;
+            }
+        } else {
+            std::cerr << "unknown option: " << option << '\n';
+            return 2;
+        }
+    }
+
+    if (event) {
+        for (const auto& hit : FindLogEvents(directory, *event)) {
+            std::cout << "----- " << kLogFormats[static_cast<std::size_t>(*event)] << " at ";
+            PrintTimestamp(hit.timestampMs);
+            std::cout << " -----\n";
+            PrintWindow(directory, hit.timestampMs - beforeMs, hit.timestampMs + afterMs);
+        }
+        return 0;
+    }
+
+    if (!fromMs || !toMs) {
+        std::cerr << "query needs --event or both --from and --to\n";
+        return 2;
+    }
+    PrintWindow(directory, *fromMs, *toMs);
+    return 0;
+}
+
+int PrintUsage() {
+    std::cerr << "usage: bwy_logtool flight <file.flight>\n"
+                 "       bwy_logtool decode <file.blog>\n"
+                 "       bwy_logtool query <log folder> --from <time> --to <time>\n"
+                 "       bwy_logtool query <log folder> --event <name> [--before <s>] [--after <s>]\n";
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return PrintUsage();
+    }
+
+    std::string_view command = argv[1];
+    if (command == "flight" && argc == 3) {
+        return RunFlight(argv[2]);
+    }
+    if (command == "decode" && argc == 3) {
+        return RunDecode(argv[2]);
+    }
+    if (command == "query" && argc >= 5) {
+        return RunQuery(argv[2], argc - 3, argv + 3);
+    }
+    return PrintUsage();
+}